@@ -0,0 +1,150 @@
+/*
+ * ChuhaBot LIDAR Baseline Cache
+ * =============================
+ *
+ * Reading, mapping and writing of the per-beam baseline file.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "baseline_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define BASELINE_MAGIC "CHUHABL1"
+
+typedef struct {
+    char magic[8];
+    BaselineKey key;
+} BaselineHeader;
+
+static int keys_match(const BaselineKey *a, const BaselineKey *b) {
+    return a->layers == b->layers && a->resolution == b->resolution &&
+           a->fov == b->fov && a->vertical_fov == b->vertical_fov &&
+           a->max_range == b->max_range;
+}
+
+static size_t table_size(const BaselineKey *key) {
+    return sizeof(BaselineHeader) + (size_t)key->layers * key->resolution * sizeof(float);
+}
+
+#if defined(_WIN32)
+// No mmap: read the file into one heap block
+static void *map_file(const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    void *data = length > 0 ? malloc((size_t)length) : NULL;
+    if (data && fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+static void unmap_file(void *data, size_t size) {
+    (void)size;
+    free(data);
+}
+#else
+static void *map_file(const char *path, size_t *size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat info;
+    void *data = NULL;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+    }
+    close(fd);
+    *size = data ? (size_t)info.st_size : 0;
+    return data;
+}
+
+static void unmap_file(void *data, size_t size) {
+    munmap(data, size);
+}
+#endif
+
+int baseline_cache_open(BaselineCache *cache, const char *path, const BaselineKey *key) {
+    memset(cache, 0, sizeof(*cache));
+
+    size_t size;
+    void *data = map_file(path, &size);
+    if (!data) return 0;
+
+    const BaselineHeader *header = (const BaselineHeader *)data;
+    if (size != table_size(key) || memcmp(header->magic, BASELINE_MAGIC, 8) != 0 ||
+        !keys_match(&header->key, key)) {
+        unmap_file(data, size);
+        return 0;
+    }
+
+    cache->mapping = data;
+    cache->mapping_size = size;
+    cache->key = *key;
+    cache->ranges = (const float *)(header + 1);
+    return 1;
+}
+
+void baseline_cache_close(BaselineCache *cache) {
+    if (cache->mapping) unmap_file(cache->mapping, cache->mapping_size);
+    memset(cache, 0, sizeof(*cache));
+}
+
+int baseline_cache_save(const char *path, const BaselineKey *key, const float *ranges) {
+    char temp_path[512];
+    snprintf(temp_path, sizeof(temp_path), "%s.%d.tmp", path, (int)getpid());
+
+    FILE *file = fopen(temp_path, "wb");
+    if (!file) return 0;
+
+    BaselineHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BASELINE_MAGIC, 8);
+    header.key = *key;
+
+    size_t count = (size_t)key->layers * key->resolution;
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(ranges, sizeof(float), count, file) == count;
+    ok = (fclose(file) == 0) && ok;
+
+    // Readers only ever see a complete file
+#if defined(_WIN32)
+    if (ok) remove(path);
+#endif
+    if (!ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    return 1;
+}
+
+void baseline_cache_default_path(const BaselineKey *key, char *path, size_t size) {
+    // Every key field is in the name, so LIDARs that differ in any of them
+    // keep separate files instead of overwriting each other's
+    snprintf(path, size, "lidar_baseline_%dx%d_%d_%d_%d.bin", key->layers, key->resolution,
+             (int)(key->fov * 1000.0f + 0.5f), (int)(key->vertical_fov * 1000.0f + 0.5f),
+             (int)(key->max_range * 1000.0f + 0.5f));
+}
@@ -0,0 +1,50 @@
+/*
+ * ChuhaBot LIDAR Baseline Cache
+ * =============================
+ *
+ * Per-beam floor baselines (the range each beam of each layer measures in
+ * an empty arena), stored in a compact binary file keyed on the LIDAR
+ * parameters. The file is memory-mapped read-only, so any number of robots
+ * starting at once share one copy through the page cache.
+ *
+ * File layout (native byte order):
+ *   BaselineHeader, then layers * resolution floats, layer-major
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef BASELINE_CACHE_H
+#define BASELINE_CACHE_H
+
+#include <stddef.h>
+
+// LIDAR parameters a baseline table is valid for. tiltAngle is not exposed
+// to robot controllers, so differently tilted LIDARs need distinct files.
+typedef struct {
+    int layers;
+    int resolution;
+    float fov;
+    float vertical_fov;
+    float max_range;
+} BaselineKey;
+
+typedef struct {
+    const float *ranges;        // layers * resolution baselines, NULL if not loaded
+    BaselineKey key;
+    void *mapping;              // Start of the mapped (or read) file
+    size_t mapping_size;
+} BaselineCache;
+
+// Map the baseline file at path if its key matches. Returns 1 on success.
+int baseline_cache_open(BaselineCache *cache, const char *path, const BaselineKey *key);
+
+void baseline_cache_close(BaselineCache *cache);
+
+// Write a baseline table atomically (temporary file + rename). Returns 1 on success.
+int baseline_cache_save(const char *path, const BaselineKey *key, const float *ranges);
+
+// Default cache file name for a key, e.g. "lidar_baseline_16x512_6283_300_6000.bin"
+void baseline_cache_default_path(const BaselineKey *key, char *path, size_t size);
+
+#endif
@@ -9,6 +9,7 @@ param(
 # Configuration
 $ControllerName = "chuha_c_controller"
 $SourceFile = "$ControllerName.c"
+$KernelSources = "scan_kernels.c neighbor_tracker.c baseline_cache.c sector_map.c robot_rng.c fast_math.c fixed_point.c swarm_fixed.c tracker_fixed.c perception_fixed.c dynamic_window.c formation.c framebuffer.c step_profile.c scan_recording.c"
 $OutputFile = "$ControllerName.exe"
 
 # Colors for output
@@ -114,14 +115,14 @@ function Build-Controller {
     
     switch ($script:Compiler) {
         "gcc" {
-            $buildCommand = "gcc -Wall -O2 -I`"$includeDir`" -L`"$libDir`" -o $OutputFile $SourceFile -lController"
+            $buildCommand = "gcc -Wall -O2 -fopenmp-simd -I`"$includeDir`" -L`"$libDir`" -o $OutputFile $SourceFile $KernelSources -lController"
         }
         "clang" {
-            $buildCommand = "clang -Wall -O2 -I`"$includeDir`" -L`"$libDir`" -o $OutputFile $SourceFile -lController"
+            $buildCommand = "clang -Wall -O2 -fopenmp-simd -I`"$includeDir`" -L`"$libDir`" -o $OutputFile $SourceFile $KernelSources -lController"
         }
         "cl" {
             # Visual Studio compiler
-            $buildCommand = "cl /O2 /I`"$includeDir`" $SourceFile /link /LIBPATH:`"$libDir`" Controller.lib /OUT:$OutputFile"
+            $buildCommand = "cl /O2 /I`"$includeDir`" $SourceFile $KernelSources /link /LIBPATH:`"$libDir`" Controller.lib /OUT:$OutputFile"
         }
         default {
             Write-Error "Unsupported compiler: $script:Compiler"
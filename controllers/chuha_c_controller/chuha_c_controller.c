@@ -20,91 +20,670 @@
 #include <webots/robot.h>
 #include <webots/motor.h>
 #include <webots/lidar.h>
+#ifndef HEADLESS
 #include <webots/display.h>
 #include <webots/keyboard.h>
+#endif
+#include <float.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "baseline_cache.h"
+#include "dynamic_window.h"
+#include "fast_math.h"
+#include "formation.h"
+#include "framebuffer.h"
+#include "neighbor_tracker.h"
+#include "perception_fixed.h"
+#include "precision.h"
+#include "robot_rng.h"
+#include "scan_kernels.h"
+#include "scan_recording.h"
+#include "sector_map.h"
+#include "step_profile.h"
+#include "swarm_fixed.h"
+
 // Constants
-#define MAX_NEIGHBORS 32
+#ifndef MAX_NEIGHBORS
+#define MAX_NEIGHBORS 32        // Neighbor capacity, make NEIGHBOR_CAPACITY=N to change
+#endif
 #define LIDAR_RANGE_COUNT 16
 #define DISPLAY_WIDTH 512
 #define DISPLAY_HEIGHT 512
 #define MAX_SPEED 60.0
 #define PI 3.14159265359
+#define MAX_LIDAR_RESOLUTION 4096
+#define MAX_CALIBRATION_FRAMES 65535   // Per-beam calibration sample counts are 16-bit
+#define DEFAULT_PROFILE_EVERY 7        // Prime, so the timed steps drift through LIDAR and display periods
+
+// Per-phase step timing (step_profile.c), compiled out by make PROFILE=off.
+// Only every profile_every-th step is timed (--profile-every). PROFILE_PHASE
+// charges the time since the previous mark to a phase; PROFILE_END charges
+// the whole step up to the last mark, without another clock read.
+#ifdef NO_STEP_PROFILE
+#define PROFILE_BEGIN()
+#define PROFILE_PHASE(phase)
+#define PROFILE_END()
+#else
+#define PROFILE_BEGIN() \
+    int profiling = robot_state.step_count % profile_every == 0; \
+    uint64_t profile_start = profiling ? step_profile_ticks() : 0, profile_mark = profile_start
+#define PROFILE_PHASE(phase) \
+    do { if (profiling) profile_mark = step_profile_lap(&step_profile, phase, profile_mark); } while (0)
+#define PROFILE_END() \
+    do { if (profiling) latency_histogram_record(&step_profile.phase[PHASE_STEP], profile_mark - profile_start); } while (0)
+#endif
+
+// Cache-line alignment for the per-beam lookup tables
+#if defined(_MSC_VER)
+#define ALIGNED(n) __declspec(align(n))
+#else
+#define ALIGNED(n) __attribute__((aligned(n)))
+#endif
 
 // Behavior weights (configurable)
 typedef struct {
-    double separation;
-    double alignment; 
-    double cohesion;
-    double obstacle_avoidance;
-    double wander;
+    real separation;
+    real alignment; 
+    real cohesion;
+    real obstacle_avoidance;
+    real wander;
+    real formation;             // 0 unless --formation is given
 } BehaviorWeights;
 
-// Neighbor structure
+// Neighbor store, one aligned array per field so the behavior loops vectorize
 typedef struct {
-    double x, y;
-    double distance;
-    double angle;
-} Neighbor;
+    int count;
+    ALIGNED(64) float x[MAX_NEIGHBORS];
+    ALIGNED(64) float y[MAX_NEIGHBORS];
+    ALIGNED(64) float range[MAX_NEIGHBORS];
+    ALIGNED(64) float bearing[MAX_NEIGHBORS];
+    ALIGNED(64) float vx[MAX_NEIGHBORS];          // Own velocity in this robot's frame, 0 unless known
+    ALIGNED(64) float vy[MAX_NEIGHBORS];
+    ALIGNED(64) int id[MAX_NEIGHBORS];            // Stable track ID, 0 if untracked
+    ALIGNED(64) int velocity_known[MAX_NEIGHBORS]; // Track confirmed, vx/vy are usable
+} NeighborSet;
 
 // Robot state
 typedef struct {
     char name[64];
-    double position[2];
-    double velocity[2];
-    double heading;
-    int neighbor_count;
-    Neighbor neighbors[MAX_NEIGHBORS];
+    real position[2];
+    real velocity[2];
+    real heading;
     BehaviorWeights weights;
     int step_count;
-    double last_force[2];
+    real obstacle_force[2];
+    real last_force[2];
+    real wheel_velocity[2];     // Last motor command, left and right (rad/s)
+    int turn_direction;         // Sign of the last turn command: 1 left, -1 right, 0 none
+    int front_blocked;          // Hit inside the braking window in the last scan
+    RobotRng rng;               // Per-robot generator, seeded from the name or --seed
+    real wander_angle;
 } RobotState;
 
+// Per-neighbor terms of the neighbor-based behaviors, summed in one pass
+typedef struct {
+    real separation[2];         // Inverse-distance push away from close neighbors
+    real velocity[2];           // Sum of tracked neighbor velocities
+    int tracked;                // Neighbors with a known velocity
+    real position[2];           // Sum of neighbor positions
+    int count;
+} NeighborSums;
+
+// Behaviors are registered in a table, like add_behavior() in the Python
+// framework. Each one turns the shared neighbor sums (and any robot state it
+// needs) into a force; behaviors whose weight is zero are not run at all.
+#define MAX_BEHAVIORS 8
+
+typedef void (*BehaviorFunction)(const NeighborSums *sums, real *force_x, real *force_y);
+
+typedef struct {
+    const char *name;
+    BehaviorFunction compute;
+    const real *weight;         // Live weight, usually a BehaviorWeights field
+    int uses_neighbor_sums;     // Needs accumulate_neighbor_sums() to have run
+} Behavior;
+
+// How the behavior force becomes wheel speeds
+typedef enum {
+    PLANNER_DIRECT,             // Fixed gains, forces_to_motor_velocities()
+    PLANNER_DYNAMIC_WINDOW      // Sampled and scored candidates, dynamic_window.c
+} Planner;
+
+// Controller arguments (controllerArgs in the world file)
+typedef struct {
+    int lidar_period;           // LIDAR sampling period in ms, 0 = control timestep
+    int calibrate_frames;       // Empty-arena scans to average into baselines, 0 = off
+    char baseline_file[256];    // Baseline cache path, empty = derived from the LIDAR key
+    int weights_given;          // --weights was passed
+    int formation_weight_given; // ... with a sixth, formation weight
+    BehaviorWeights weights;    // Initial behavior weights when weights_given
+    int seed_given;             // --seed was passed
+    uint64_t seed;
+    Planner planner;            // --planner=direct|window
+    double visualization_rate;  // --viz-rate, display frames per second, 0 = start disabled
+    char frame_dump[256];       // --frame-dump, PNG path prefix per rendered frame, empty = off
+    char record_scans[256];     // --record-scans, scan recording path, empty = off
+    int profile_every;          // --profile-every, time every Nth step, 0 = DEFAULT_PROFILE_EVERY
+    double profile_report;      // --profile-report, seconds between step profile reports, 0 = at the end only
+    FormationType formation;    // --formation=circle|line|v
+} ControllerConfig;
+
+// Hits belonging to one object, as spans of the compacted hit arrays. An
+// object straddling the +/-PI seam also owns a wrapped span at the end.
+typedef struct {
+    int start, count;
+    int wrap_start, wrap_count;
+} ScanCluster;
+
+// Per-beam angle lookup tables, rebuilt whenever the LIDAR resolution changes.
+// The beams are spread evenly over the field of view, centered straight ahead.
+typedef struct {
+    int resolution;             // Resolution reported by the LIDAR
+    int width;                  // Beams covered by the tables
+    double beam_step;           // Radians between neighboring beams
+    ALIGNED(64) float angle[MAX_LIDAR_RESOLUTION];
+    ALIGNED(64) float cos_angle[MAX_LIDAR_RESOLUTION];
+    ALIGNED(64) float sin_angle[MAX_LIDAR_RESOLUTION];
+#if defined(RANGE_FIXED_MM) && !defined(CONTROL_FIXED_Q16)
+    ALIGNED(64) int16_t cos_q15[MAX_LIDAR_RESOLUTION];
+    ALIGNED(64) int16_t sin_q15[MAX_LIDAR_RESOLUTION];
+#endif
+} BeamTables;
+
 // Global variables
 static WbDeviceTag robot_device;
 static WbDeviceTag left_motor, right_motor;
 static WbDeviceTag lidar;
-static WbDeviceTag display;
 static RobotState robot_state;
+static NeighborSet neighbors;
+static Behavior behaviors[MAX_BEHAVIORS];
+static int behavior_count = 0;
+
+#ifdef CONTROL_FIXED_Q16
+// Q16.16 perception and steering (perception_fixed.c, swarm_fixed.c)
+static FixedPerception fixed_perception;
+static FixedSwarm fixed_swarm;
+static FixedOutputs fixed_outputs;              // Last step's commands, for the ego-motion compensation
+#ifdef DEBUG
+// Float steering shadowing the fixed steering on the same inputs
+static struct {
+    long steps;
+    long flips;                 // Steps turning the other way at the atan2 branch cut
+    double max_deviation;       // rad/s, flips excluded
+    double sum_deviation;
+} fixed_check;
+#endif
+#endif
+static BeamTables beam_tables;
+static ALIGNED(64) float hit_profile[MAX_LIDAR_RESOLUTION];
+static ALIGNED(64) float scan_x[MAX_LIDAR_RESOLUTION];
+static ALIGNED(64) float scan_y[MAX_LIDAR_RESOLUTION];
+
+// Hits compacted out of the scan in angular order, and their clusters
+static ALIGNED(64) float hit_x[MAX_LIDAR_RESOLUTION];
+static ALIGNED(64) float hit_y[MAX_LIDAR_RESOLUTION];
+static ALIGNED(64) float hit_range[MAX_LIDAR_RESOLUTION];
+static ALIGNED(64) float hit_angle[MAX_LIDAR_RESOLUTION];
+static ScanCluster clusters[MAX_LIDAR_RESOLUTION];
+#ifndef CONTROL_FIXED_Q16
+static NeighborTracker neighbor_tracker;
+#endif
+static SectorMap sector_map;
+static DynamicWindow dynamic_window;
+static Formation formation;
+static int hit_count;                              // Hits compacted by the last scan
+
+// Overlay rendered in memory (framebuffer.c) and sent to the display as one image
+static ALIGNED(64) uint8_t overlay_pixels[DISPLAY_WIDTH * DISPLAY_HEIGHT * 4];
+static Framebuffer overlay;
+static int visualization_period;                   // Control steps per rendered frame
+#ifndef HEADLESS
+static WbDeviceTag display;
+static ALIGNED(64) uint8_t shown_pixels[DISPLAY_WIDTH * DISPLAY_HEIGHT * 4];  // What the display shows
+static int visualization_enabled;
+#endif
+static float member_x[FORMATION_MAX_MEMBERS], member_y[FORMATION_MAX_MEMBERS];
+static float member_vx[FORMATION_MAX_MEMBERS], member_vy[FORMATION_MAX_MEMBERS];
+static int member_key[FORMATION_MAX_MEMBERS];
+#ifndef NO_STEP_PROFILE
+static StepProfile step_profile;
+static int profile_every = DEFAULT_PROFILE_EVERY;  // Control steps per timed step
+static int profile_report_period = 0;              // Control steps per periodic report, 0 = off
+#endif
+
+// Per-beam floor baselines (replace the per-layer RANGES table when loaded)
+static BaselineCache baseline_cache;
+static BaselineKey baseline_key;
+static char baseline_path[256];
+static int calibration_frames_left = 0;
+static ScanRecording scan_recording;               // Open while --record-scans is writing
+static float calibration_sum[LIDAR_RANGE_COUNT * MAX_LIDAR_RESOLUTION];
+static unsigned short calibration_samples[LIDAR_RANGE_COUNT * MAX_LIDAR_RESOLUTION];
+static float layer_thresholds[LIDAR_RANGE_COUNT];
+
+#ifdef RANGE_FIXED_MM
+// Millimetre perception path: the hit profile and thresholds are uint16 mm
+static ALIGNED(64) uint16_t hit_profile_mm[MAX_LIDAR_RESOLUTION];
+static ALIGNED(64) uint16_t baseline_thresholds_mm[LIDAR_RANGE_COUNT * MAX_LIDAR_RESOLUTION];
+static uint16_t layer_thresholds_mm[LIDAR_RANGE_COUNT];
+static int baseline_thresholds_mm_valid = 0;
+#endif
+#if defined(RANGE_FIXED_MM) && !defined(CONTROL_FIXED_Q16)
+// Millimetre hits; the fixed-point build keeps its own in fixed_perception
+static int32_t hit_x_mm[MAX_LIDAR_RESOLUTION];
+static int32_t hit_y_mm[MAX_LIDAR_RESOLUTION];
+static uint16_t hit_range_mm[MAX_LIDAR_RESOLUTION];
+static int hit_beam[MAX_LIDAR_RESOLUTION];
+#endif
 static int timestep;
+static ControllerConfig config;
+
+// Last LIDAR frame processed; perception results are reused until a new one arrives
+static long lidar_enable_ms = 0;                   // Simulation time the LIDAR was enabled at
+static long last_scan_frame = 0;                   // Frames are numbered from 1, 0 = none yet
+static double last_scan_time = 0.0;
+static double scan_dt = 0.0;
 
 // LIDAR configuration (from original ChuhaBot)
-static double RANGES[LIDAR_RANGE_COUNT] = {
+static const real RANGES[LIDAR_RANGE_COUNT] = {
     1.13114178, 0.85820043, 0.57785118, 0.43461093,
     0.38639969, 0.31585345, 0.2667459, 0.23062678,
     0.21593061, 0.19141567, 0.17178488, 0.15571462,
     0.14872716, 0.13643947, 0.12597121, 0.11696267
 };
-static const double EPSILON = 0.6;
-static const double DELTA_THETA = 0.1;
-static const double DELTA_R = 0.02;
+static const real EPSILON = 0.6;
+static const real DELTA_THETA = 0.1;
+static const real DELTA_R = 0.02;
+
+// Perception constants of the float builds; perception_fixed.c holds the
+// fixed-point build's copies
+#ifndef CONTROL_FIXED_Q16
+// Obstacle repulsion from the sector map
+static const float OBSTACLE_MIN_RANGE = 0.05f;      // Meters, closer hits are the robot itself
+static const float OBSTACLE_MAX_RANGE = 0.4f;       // Meters
+static const float OBSTACLE_RANGE_OFFSET = 0.05f;   // Meters, caps the weight of close hits
+
+// Emergency braking: no forward motion while a hit is this close ahead
+static const real BRAKE_RANGE = 0.15;               // Meters
+static const real BRAKE_HALF_ANGLE = 0.5;           // Radians either side of straight ahead
+
+// Neighbor tracking
+static const real TRACK_GATE = 0.2;                 // Meters
+static const real TRACK_PROCESS_NOISE = 1.0;
+static const real TRACK_MEASUREMENT_NOISE = 4e-4;   // 2 cm standard deviation
+#endif
+
+// Rear cone (radians either side of straight back) in which the robot keeps
+// turning the way it turned last step
+static const real TURN_HYSTERESIS = 0.5;
+
+// Drive geometry (ChuhaBot proto) and dynamic window tuning
+static const real WHEEL_RADIUS = 0.0075;            // Meters
+static const real AXLE_LENGTH = 0.07;               // Meters between the wheels
+static const real ROBOT_RADIUS = 0.03;              // Meters
+static const real MAX_WHEEL_ACCEL = 600.0;          // rad/s^2, full speed in 0.1 s
+static const real PLANNER_HORIZON = 0.4;            // Seconds
+
+// Display refresh when --viz-rate is not given (or 0 and toggled on with V)
+static const double DEFAULT_VISUALIZATION_RATE = 10.0;   // Hz
+
+// Formation control
+static const real FORMATION_SPACING = 0.4;          // Meters between neighboring slots
+static const real FORMATION_ARRIVE = 0.1;           // Meters, force fades linearly inside this
+static const real FORMATION_WEIGHT = 1.5;           // Weight when a formation is selected
 
 // Utility functions
-double clamp(double value, double min, double max) {
+real clamp(real value, real min, real max) {
     if (value < min) return min;
     if (value > max) return max;
     return value;
 }
 
-double normalize_angle(double angle) {
-    while (angle > PI) angle -= 2.0 * PI;
-    while (angle < -PI) angle += 2.0 * PI;
+real normalize_angle(real angle) {
+    while (angle > REAL(PI)) angle -= REAL(2.0 * PI);
+    while (angle < REAL(-PI)) angle += REAL(2.0 * PI);
     return angle;
 }
 
-double vector_magnitude(double x, double y) {
-    return sqrt(x * x + y * y);
+real vector_magnitude(real x, real y) {
+    return REAL_SQRT(x * x + y * y);
+}
+
+void normalize_vector(real *x, real *y) {
+    real length_sq = *x * *x + *y * *y;
+    if (length_sq > REAL(0.001 * 0.001)) {
+        real scale = REAL_RSQRT(length_sq);
+        *x *= scale;
+        *y *= scale;
+    }
+}
+
+#ifdef CONTROL_FIXED_Q16
+// Conversions at the Webots side of the fixed-point build
+static q16 to_q16(real value) {
+    return (q16)(value * REAL(65536.0) + (value >= 0 ? REAL(0.5) : REAL(-0.5)));
+}
+
+static real from_q16(q16 value) {
+    return value / REAL(65536.0);
+}
+#endif
+
+// Build beam angle/cos/sin tables for the given horizontal resolution and
+// field of view (radians; anything outside (0, 2 * PI] is taken as 2 * PI)
+void build_beam_tables(int width, double fov) {
+    if (!(fov > 0.0 && fov <= 2.0 * PI)) fov = 2.0 * PI;
+    beam_tables.resolution = width;
+    beam_tables.beam_step = width > 0 ? fov / width : 0.0;
+    if (width > MAX_LIDAR_RESOLUTION) {
+        printf("[%s] LIDAR resolution %d exceeds %d, extra beams ignored\n",
+               robot_state.name, width, MAX_LIDAR_RESOLUTION);
+        width = MAX_LIDAR_RESOLUTION;
+    }
+    
+    for (int i = 0; i < width; i++) {
+        double angle = -fov / 2.0 + i * beam_tables.beam_step;
+        beam_tables.angle[i] = (float)angle;
+        beam_tables.cos_angle[i] = (float)cos(angle);
+        beam_tables.sin_angle[i] = (float)sin(angle);
+#if defined(RANGE_FIXED_MM) && !defined(CONTROL_FIXED_Q16)
+        beam_tables.cos_q15[i] = (int16_t)lround(cos(angle) * 32767.0);
+        beam_tables.sin_q15[i] = (int16_t)lround(sin(angle) * 32767.0);
+#endif
+    }
+    beam_tables.width = width;
+#ifdef CONTROL_FIXED_Q16
+    int sector_start[SECTOR_COUNT + 1];
+    sector_map_bounds(width, beam_tables.angle[0], beam_tables.beam_step, sector_start);
+    perception_fixed_set_beams(&fixed_perception, width, to_q16(fov), sector_start);
+#endif
+}
+
+// Return the usable beam count, rebuilding the tables if the resolution changed
+int ensure_beam_tables(int width) {
+    if (width != beam_tables.resolution) {
+        build_beam_tables(width, wb_lidar_get_fov(lidar));
+    }
+    return beam_tables.width;
+}
+
+// Precompute the per-layer "object hit" thresholds from the floor baselines
+void build_layer_thresholds() {
+    for (int layer = 0; layer < LIDAR_RANGE_COUNT; layer++) {
+        layer_thresholds[layer] = (float)(RANGES[layer] * EPSILON);
+#ifdef RANGE_FIXED_MM
+        layer_thresholds_mm[layer] = (uint16_t)(RANGES[layer] * EPSILON * REAL(1000.0) + REAL(0.5));
+#endif
+    }
+}
+
+// Collapse the multi-layer range image into one hit range per beam.
+// A beam hits an object on a layer when its range is shorter than that
+// layer's floor baseline scaled by EPSILON; the closest hit across layers
+// wins, and beams without any hit are left at FLT_MAX.
+void collapse_range_layers(const float *range_image, int layers, int stride, int width) {
+    if (layers > LIDAR_RANGE_COUNT) layers = LIDAR_RANGE_COUNT;
+    
+    for (int i = 0; i < width; i++) {
+        hit_profile[i] = FLT_MAX;
+    }
+    
+    // Calibrated per-beam baselines, when they match the current LIDAR
+    if (baseline_cache.ranges && baseline_cache.key.layers == layers &&
+        baseline_cache.key.resolution == stride && stride == width) {
+        for (int layer = 0; layer < layers; layer++) {
+            scan_kernels.baseline_min_filter(hit_profile, range_image + layer * stride,
+                                             baseline_cache.ranges + layer * stride,
+                                             (float)EPSILON, width);
+        }
+        return;
+    }
+    
+    for (int layer = 0; layer < layers; layer++) {
+        scan_kernels.layer_min_filter(hit_profile, range_image + layer * stride,
+                                      layer_thresholds[layer], width);
+    }
+}
+
+// Group the hits into objects in one O(n) pass, as get_theta_data_colored()
+// does in the Python controllers: consecutive hits closer than DELTA_THETA in
+// angle and DELTA_R / r in range belong to the same object. Objects straddling
+// the +/-PI seam of a full-circle scan are merged by appending the last
+// cluster to the first one.
+// Returns the number of hits and stores the number of clusters.
+int cluster_hits(int width, int *cluster_count) {
+    int hits = 0;
+    int count = 0;
+    
+    for (int i = 0; i < width; i++) {
+        float range = hit_profile[i];
+        if (range >= FLT_MAX) continue;
+        
+        float angle = beam_tables.angle[i];
+        if (hits == 0 ||
+            !(REAL_FABS(angle - hit_angle[hits - 1]) < DELTA_THETA &&
+              REAL_FABS(range - hit_range[hits - 1]) < DELTA_R / range)) {
+            clusters[count].start = hits;
+            clusters[count].count = 0;
+            clusters[count].wrap_start = 0;
+            clusters[count].wrap_count = 0;
+            count++;
+        }
+        
+        hit_x[hits] = scan_x[i];
+        hit_y[hits] = scan_y[i];
+        hit_range[hits] = range;
+        hit_angle[hits] = angle;
+        clusters[count - 1].count++;
+        hits++;
+    }
+    
+    // Wrap-around merge at +/-PI
+    if (count > 1) {
+        int last = hits - 1;
+        if (REAL_FABS(hit_angle[0] + REAL(2.0 * PI) - hit_angle[last]) < DELTA_THETA &&
+            REAL_FABS(hit_range[0] - hit_range[last]) < DELTA_R / hit_range[last]) {
+            count--;
+            clusters[0].wrap_start = clusters[count].start;
+            clusters[0].wrap_count = clusters[count].count;
+        }
+    }
+    
+    *cluster_count = count;
+    return hits;
+}
+
+// Centroid of a cluster, combining the wrapped span if there is one
+void cluster_centroid(const ScanCluster *cluster, real *x, real *y) {
+    float cx, cy;
+    scan_kernels.point_centroid(hit_x + cluster->start, hit_y + cluster->start,
+                                cluster->count, &cx, &cy);
+    *x = cx;
+    *y = cy;
+    
+    if (cluster->wrap_count > 0) {
+        float wx, wy;
+        scan_kernels.point_centroid(hit_x + cluster->wrap_start, hit_y + cluster->wrap_start,
+                                    cluster->wrap_count, &wx, &wy);
+        real total = (real)(cluster->count + cluster->wrap_count);
+        *x = (*x * cluster->count + wx * cluster->wrap_count) / total;
+        *y = (*y * cluster->count + wy * cluster->wrap_count) / total;
+    }
+}
+
+#ifdef RANGE_FIXED_MM
+// Convert the loaded per-beam baselines to millimetre hit thresholds
+void build_baseline_thresholds_mm() {
+    baseline_thresholds_mm_valid = 0;
+    if (!baseline_cache.ranges) return;
+    
+    int count = baseline_cache.key.layers * baseline_cache.key.resolution;
+    for (int i = 0; i < count; i++) {
+        real threshold = baseline_cache.ranges[i] * EPSILON * REAL(1000.0);
+        baseline_thresholds_mm[i] = threshold < RANGE_MM_NONE ? (uint16_t)threshold : RANGE_MM_NONE;
+    }
+    baseline_thresholds_mm_valid = 1;
+}
+
+// Collapse the layers as collapse_range_layers() does, on 16-bit lanes; the
+// kernels quantize each row to millimetres as they read it
+void collapse_range_layers_mm(const float *range_image, int layers, int stride, int width) {
+    if (layers > LIDAR_RANGE_COUNT) layers = LIDAR_RANGE_COUNT;
+    
+    for (int i = 0; i < width; i++) {
+        hit_profile_mm[i] = RANGE_MM_NONE;
+    }
+    
+    int use_baselines = baseline_thresholds_mm_valid && baseline_cache.key.layers == layers &&
+                        baseline_cache.key.resolution == stride && stride == width;
+    for (int layer = 0; layer < layers; layer++) {
+        if (use_baselines) {
+            scan_kernels.threshold_min_filter_mm(hit_profile_mm, range_image + layer * stride,
+                                                 baseline_thresholds_mm + layer * width, width);
+        } else {
+            scan_kernels.layer_min_filter_mm(hit_profile_mm, range_image + layer * stride,
+                                             layer_thresholds_mm[layer], width);
+        }
+    }
 }
 
-void normalize_vector(double *x, double *y) {
-    double mag = vector_magnitude(*x, *y);
-    if (mag > 0.001) {
-        *x /= mag;
-        *y /= mag;
+#ifndef CONTROL_FIXED_Q16
+// Millimetre version of cluster_hits(): the angular test becomes a beam
+// index gap and DELTA_R / r becomes |dr| * r < DELTA_R in mm^2. Both
+// factors reach 65534 mm, so the product is 64-bit.
+int cluster_hits_mm(int width, int *cluster_count) {
+    const real max_gap = (real)(DELTA_THETA / beam_tables.beam_step);
+    const real beams_per_turn = (real)(2.0 * PI / beam_tables.beam_step);
+    const int64_t max_dr_r = (int64_t)(DELTA_R * REAL(1e6));
+    int hits = 0;
+    int count = 0;
+    
+    for (int i = 0; i < width; i++) {
+        int32_t range = hit_profile_mm[i];
+        if (range == RANGE_MM_NONE) continue;
+        
+        if (hits == 0 ||
+            !(i - hit_beam[hits - 1] < max_gap &&
+              (int64_t)abs(range - hit_range_mm[hits - 1]) * range < max_dr_r)) {
+            clusters[count].start = hits;
+            clusters[count].count = 0;
+            clusters[count].wrap_start = 0;
+            clusters[count].wrap_count = 0;
+            count++;
+        }
+        
+        hit_x_mm[hits] = (range * beam_tables.cos_q15[i]) >> 15;
+        hit_y_mm[hits] = (range * beam_tables.sin_q15[i]) >> 15;
+        hit_range_mm[hits] = (uint16_t)range;
+        hit_beam[hits] = i;
+        clusters[count - 1].count++;
+        hits++;
+    }
+    
+    // Wrap-around merge at +/-PI
+    if (count > 1) {
+        int last = hits - 1;
+        if (hit_beam[0] - hit_beam[last] + beams_per_turn < max_gap &&
+            (int64_t)abs(hit_range_mm[0] - hit_range_mm[last]) * hit_range_mm[last] < max_dr_r) {
+            count--;
+            clusters[0].wrap_start = clusters[count].start;
+            clusters[0].wrap_count = clusters[count].count;
+        }
+    }
+    
+    *cluster_count = count;
+    return hits;
+}
+
+// Centroid of a millimetre cluster, in meters
+void cluster_centroid_mm(const ScanCluster *cluster, real *x, real *y) {
+    int32_t sum_x = 0, sum_y = 0;
+    for (int i = cluster->start; i < cluster->start + cluster->count; i++) {
+        sum_x += hit_x_mm[i];
+        sum_y += hit_y_mm[i];
+    }
+    for (int i = cluster->wrap_start; i < cluster->wrap_start + cluster->wrap_count; i++) {
+        sum_x += hit_x_mm[i];
+        sum_y += hit_y_mm[i];
+    }
+    int total = cluster->count + cluster->wrap_count;
+    *x = sum_x / (REAL(1000.0) * total);
+    *y = sum_y / (REAL(1000.0) * total);
+}
+#endif
+#endif
+
+// Load the per-beam baselines for this LIDAR, or start calibrating them
+void setup_baselines() {
+    baseline_key.layers = wb_lidar_get_number_of_layers(lidar);
+    baseline_key.resolution = wb_lidar_get_horizontal_resolution(lidar);
+    baseline_key.fov = (float)wb_lidar_get_fov(lidar);
+    baseline_key.vertical_fov = (float)wb_lidar_get_vertical_fov(lidar);
+    baseline_key.max_range = (float)wb_lidar_get_max_range(lidar);
+    
+    if (config.baseline_file[0]) {
+        snprintf(baseline_path, sizeof(baseline_path), "%s", config.baseline_file);
+    } else {
+        baseline_cache_default_path(&baseline_key, baseline_path, sizeof(baseline_path));
+    }
+    
+    if (config.calibrate_frames > 0) {
+        if (baseline_key.layers > LIDAR_RANGE_COUNT || baseline_key.resolution > MAX_LIDAR_RESOLUTION) {
+            printf("[%s] LIDAR too large to calibrate (%dx%d)\n", robot_state.name,
+                   baseline_key.layers, baseline_key.resolution);
+            return;
+        }
+        calibration_frames_left = config.calibrate_frames;
+        memset(calibration_sum, 0, sizeof(calibration_sum));
+        memset(calibration_samples, 0, sizeof(calibration_samples));
+        printf("[%s] Calibrating floor baselines over %d scans, keep the arena empty\n",
+               robot_state.name, calibration_frames_left);
+    } else if (baseline_cache_open(&baseline_cache, baseline_path, &baseline_key)) {
+        printf("[%s] Per-beam baselines loaded from %s\n", robot_state.name, baseline_path);
+    }
+#ifdef RANGE_FIXED_MM
+    build_baseline_thresholds_mm();
+#endif
+}
+
+// Add one empty-arena scan to the calibration sums
+void accumulate_calibration_scan() {
+    const float *range_image = wb_lidar_get_range_image(lidar);
+    if (!range_image) return;
+    
+    int count = baseline_key.layers * baseline_key.resolution;
+    for (int i = 0; i < count; i++) {
+        float range = range_image[i];
+        if (range > 0.0f && range < FLT_MAX) {
+            calibration_sum[i] += range;
+            calibration_samples[i]++;
+        }
+    }
+    calibration_frames_left--;
+}
+
+// Average the calibration scans, persist them and switch to the new table.
+// Beams that saw no floor in most scans get FLT_MAX: any return there is an object.
+void finish_calibration() {
+    int count = baseline_key.layers * baseline_key.resolution;
+    int frames = config.calibrate_frames;
+    for (int i = 0; i < count; i++) {
+        calibration_sum[i] = (2 * calibration_samples[i] >= frames)
+                                 ? calibration_sum[i] / calibration_samples[i]
+                                 : FLT_MAX;
+    }
+    
+    if (baseline_cache_save(baseline_path, &baseline_key, calibration_sum) &&
+        baseline_cache_open(&baseline_cache, baseline_path, &baseline_key)) {
+        printf("[%s] Baselines calibrated and saved to %s\n", robot_state.name, baseline_path);
+#ifdef RANGE_FIXED_MM
+        build_baseline_thresholds_mm();
+#endif
+    } else {
+        printf("[%s] WARNING: could not save baselines to %s\n", robot_state.name, baseline_path);
     }
 }
 
@@ -122,15 +701,73 @@ void initialize_robot() {
     wb_motor_set_velocity(left_motor, 0.0);
     wb_motor_set_velocity(right_motor, 0.0);
     
+    // Select the scan kernels for this CPU
+    scan_kernels_init();
+#ifdef DEBUG
+    if (scan_kernels_self_check(1e-4f) != 0) {
+        printf("[%s] WARNING: scan kernel self-check failed\n", robot_state.name);
+    }
+    if (fast_math_self_check() != 0) {
+        printf("[%s] WARNING: fast math self-check failed\n", robot_state.name);
+    }
+#ifndef NO_STEP_PROFILE
+    if (step_profile_self_check() != 0) {
+        printf("[%s] WARNING: step profile self-check failed\n", robot_state.name);
+    }
+#endif
+#endif
+    
     // Initialize LIDAR
     lidar = wb_robot_get_device("lidar");
-    wb_lidar_enable(lidar, timestep);
+    int lidar_period = config.lidar_period > 0 ? config.lidar_period : timestep;
+    wb_lidar_enable(lidar, lidar_period);
+    lidar_enable_ms = (long)(wb_robot_get_time() * 1000.0 + 0.5);
+    build_beam_tables(wb_lidar_get_horizontal_resolution(lidar), wb_lidar_get_fov(lidar));
+    build_layer_thresholds();
+    setup_baselines();
+    if (config.record_scans[0] != '\0') {
+        if (scan_recording_create(&scan_recording, config.record_scans, &baseline_key, lidar_period, timestep)) {
+            printf("[%s] Recording scans to %s\n", robot_state.name, config.record_scans);
+        } else {
+            printf("[%s] WARNING: could not create %s\n", robot_state.name, config.record_scans);
+        }
+    }
+    sector_map_clear(&sector_map);                 // Clear until the first scan
+#ifdef CONTROL_FIXED_Q16
+    perception_fixed_init(&fixed_perception);      // Beam geometry comes from build_beam_tables()
+    swarm_fixed_init(&fixed_swarm, Q16(MAX_SPEED));
+#else
+    tracker_init(&neighbor_tracker, TRACK_GATE, TRACK_PROCESS_NOISE, TRACK_MEASUREMENT_NOISE);
+#endif
+    DynamicWindowConfig window_config = {
+        WHEEL_RADIUS, AXLE_LENGTH, MAX_SPEED, MAX_WHEEL_ACCEL, ROBOT_RADIUS, PLANNER_HORIZON,
+        1.0f, 0.5f, 0.5f                           // Heading, clearance and speed weights
+    };
+    dynamic_window_init(&dynamic_window, &window_config);
+    formation_init(&formation, config.formation, FORMATION_SPACING);
+#ifndef NO_STEP_PROFILE
+    step_profile_reset(&step_profile);
+    profile_every = config.profile_every > 0 ? config.profile_every : DEFAULT_PROFILE_EVERY;
+    profile_report_period = config.profile_report > 0.0
+                                ? (int)(config.profile_report * 1000.0 / timestep + 0.5) : 0;
+    if (config.profile_report > 0.0 && profile_report_period < 1) profile_report_period = 1;
+#endif
+    
+    // Overlay frames are rendered at their own rate rather than every control step
+    framebuffer_init(&overlay, overlay_pixels, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    double visualization_rate = config.visualization_rate > 0.0 ? config.visualization_rate
+                                                               : DEFAULT_VISUALIZATION_RATE;
+    visualization_period = (int)(1000.0 / (visualization_rate * timestep) + 0.5);
+    if (visualization_period < 1) visualization_period = 1;
     
+#ifndef HEADLESS
     // Initialize display
     display = wb_robot_get_device("extra_display");
+    visualization_enabled = config.visualization_rate > 0.0;
     
     // Initialize keyboard
     wb_keyboard_enable(timestep);
+#endif
     
     // Initialize robot state
     robot_state.position[0] = 0.0;
@@ -138,10 +775,21 @@ void initialize_robot() {
     robot_state.velocity[0] = 0.0;
     robot_state.velocity[1] = 0.0;
     robot_state.heading = 0.0;
-    robot_state.neighbor_count = 0;
+    neighbors.count = 0;
     robot_state.step_count = 0;
+    robot_state.obstacle_force[0] = 0.0;
+    robot_state.obstacle_force[1] = 0.0;
     robot_state.last_force[0] = 0.0;
     robot_state.last_force[1] = 0.0;
+    robot_state.wheel_velocity[0] = 0.0;
+    robot_state.wheel_velocity[1] = 0.0;
+    robot_state.turn_direction = 0;
+    robot_state.front_blocked = 0;
+    robot_state.wander_angle = 0.0;
+    
+    // Random stream per robot name: robots differ, and --seed makes a run reproducible
+    uint64_t name_hash = rng_hash_string(robot_state.name);
+    rng_seed(&robot_state.rng, config.seed_given ? config.seed : name_hash, name_hash);
     
     // Default behavior weights
     robot_state.weights.separation = 2.0;
@@ -149,103 +797,299 @@ void initialize_robot() {
     robot_state.weights.cohesion = 1.5;
     robot_state.weights.obstacle_avoidance = 3.0;
     robot_state.weights.wander = 0.5;
+    robot_state.weights.formation = config.formation != FORMATION_NONE ? FORMATION_WEIGHT : REAL(0.0);
+    if (config.weights_given) {
+        real formation_weight = robot_state.weights.formation;
+        robot_state.weights = config.weights;
+        if (!config.formation_weight_given) robot_state.weights.formation = formation_weight;
+    }
     
     printf("[%s] C-based ChuhaBot controller initialized\n", robot_state.name);
+#ifdef HEADLESS
+    printf("LIDAR enabled, Motors configured, headless build (no display or keyboard)\n");
+#else
     printf("LIDAR enabled, Motors configured, Display ready\n");
+    if (visualization_enabled) {
+        printf("Visualization: every %d control steps (%.1f Hz)\n", visualization_period,
+               1000.0 / (visualization_period * timestep));
+    } else {
+        printf("Visualization: off (press V to enable)\n");
+    }
+#endif
+    if (config.frame_dump[0] != '\0') {
+        printf("Frame dump: %sNNNNNN.png every %d control steps\n", config.frame_dump, visualization_period);
+    }
+#ifdef RANGE_FIXED_MM
+    printf("Scan kernels: %s (uint16 millimetre ranges)\n", scan_kernels.name);
+#else
+    printf("Scan kernels: %s\n", scan_kernels.name);
+#endif
+#ifdef CONTROL_FIXED_Q16
+    printf("Controller math: Q16.16 fixed-point steering\n");
+    if (config.planner == PLANNER_DYNAMIC_WINDOW) {
+        printf("[%s] --planner=window is not available in the fixed-point build\n", robot_state.name);
+    }
+#else
+    printf("Controller math: %s, %s tier\n", REAL_NAME, MATH_TIER_NAME);
+    printf("Planner: %s\n", config.planner == PLANNER_DYNAMIC_WINDOW ? "dynamic window" : "direct");
+#endif
+    if (config.formation != FORMATION_NONE) {
+#ifdef CONTROL_FIXED_Q16
+        printf("[%s] --formation is not available in the fixed-point build\n", robot_state.name);
+#else
+        printf("Formation: %s, %.2f m spacing\n", formation_type_name(config.formation), FORMATION_SPACING);
+#endif
+    }
+    printf("Control period: %d ms, LIDAR period: %d ms\n", timestep, lidar_period);
+#ifdef NO_STEP_PROFILE
+    if (config.profile_every > 0 || config.profile_report > 0.0) {
+        printf("[%s] --profile-every and --profile-report need a build with the step profile\n", robot_state.name);
+    }
+#else
+    if (profile_every > 1) printf("Step profile: timing every %d control steps\n", profile_every);
+    if (profile_report_period > 0) {
+        printf("Step profile: reported every %d control steps\n", profile_report_period);
+    }
+#endif
+}
+
+// Check whether the LIDAR has delivered a frame since the last processed one.
+// Webots takes the first measurement one sampling period after the LIDAR is
+// enabled and then one every period, so the number of frames delivered so
+// far follows from the simulation time elapsed since wb_lidar_enable().
+int scan_frame_is_new() {
+    int period = wb_lidar_get_sampling_period(lidar);
+    if (period <= 0) return 0;
+    
+    double now = wb_robot_get_time();
+    long frame = ((long)(now * 1000.0 + 0.5) - lidar_enable_ms) / period;
+    if (frame < 1 || frame == last_scan_frame) return 0;
+    
+    scan_dt = last_scan_frame == 0 ? period / 1000.0 : now - last_scan_time;
+    last_scan_frame = frame;
+    last_scan_time = now;
+    return 1;
+}
+
+// Append the current frame to --record-scans, calibration frames included,
+// so a replay sees exactly what this run saw. Stops on the first write error.
+void record_scan_frame() {
+    const float *range_image = wb_lidar_get_range_image(lidar);
+    if (!scan_recording.file || !range_image) return;
+    if (!scan_recording_write(&scan_recording, range_image)) {
+        printf("[%s] Could not write %s, scan recording stopped\n", robot_state.name, config.record_scans);
+        scan_recording_close(&scan_recording);
+    }
+}
+
+#ifndef CONTROL_FIXED_Q16
+// Give neighbors stable IDs and velocity estimates from the tracker.
+// Tracks live in this robot's frame, so their velocity also contains this
+// robot's own motion: a static object seems to approach at the forward speed
+// and sweep around while turning. That motion is added back, estimated from
+// the last wheel command (forward speed along x, yaw rate about the robot),
+// so vx/vy are the neighbors' own velocities expressed in the robot frame.
+void track_neighbors() {
+    real det_x[TRACKER_MAX_DETECTIONS] = {0.0}, det_y[TRACKER_MAX_DETECTIONS] = {0.0};
+    int track_index[TRACKER_MAX_DETECTIONS];
+    int count = neighbors.count < TRACKER_MAX_DETECTIONS ? neighbors.count : TRACKER_MAX_DETECTIONS;
+    
+    for (int i = 0; i < count; i++) {
+        det_x[i] = neighbors.x[i];
+        det_y[i] = neighbors.y[i];
+    }
+    tracker_update(&neighbor_tracker, (real)scan_dt, det_x, det_y, count, track_index);
+    
+    real ego_speed = (robot_state.wheel_velocity[0] + robot_state.wheel_velocity[1]) * WHEEL_RADIUS / REAL(2.0);
+    real yaw_rate = (robot_state.wheel_velocity[1] - robot_state.wheel_velocity[0]) * WHEEL_RADIUS / AXLE_LENGTH;
+    
+    // Neighbors past the tracker's capacity stay untracked
+    for (int i = 0; i < neighbors.count; i++) {
+        int slot = i < count ? track_index[i] : -1;
+        const Track *track = slot >= 0 ? &neighbor_tracker.tracks[slot] : NULL;
+        neighbors.id[i] = track ? track->id : 0;
+        neighbors.velocity_known[i] = track && tracker_is_confirmed(track);
+        if (neighbors.velocity_known[i]) {
+            neighbors.vx[i] = (float)(track->state[2] + ego_speed - yaw_rate * track->state[1]);
+            neighbors.vy[i] = (float)(track->state[3] + yaw_rate * track->state[0]);
+        } else {
+            neighbors.vx[i] = 0.0f;
+            neighbors.vy[i] = 0.0f;
+        }
+    }
 }
 
-// Detect neighbors using LIDAR data
-void detect_neighbors() {
+// Process one LIDAR scan: the layers are collapsed into a hit profile, which
+// is summarized into the sector map and clustered into neighbor candidates.
+// Obstacle repulsion is read from the sector map, not from the raw beams.
+void process_scan() {
+    neighbors.count = 0;
+    robot_state.obstacle_force[0] = 0.0;
+    robot_state.obstacle_force[1] = 0.0;
+    
+    robot_state.front_blocked = 0;
+    
     const float *range_image = wb_lidar_get_range_image(lidar);
     if (!range_image) {
-        robot_state.neighbor_count = 0;
+        sector_map_clear(&sector_map);
+        hit_count = 0;
         return;
     }
     
-    int width = wb_lidar_get_horizontal_resolution(lidar);
-    robot_state.neighbor_count = 0;
+    int width = ensure_beam_tables(wb_lidar_get_horizontal_resolution(lidar));
+    int layers = wb_lidar_get_number_of_layers(lidar);
+    int cluster_count;
     
-    // Process LIDAR data to find potential neighbors
-    for (int i = 0; i < width && robot_state.neighbor_count < MAX_NEIGHBORS; i++) {
-        double range = range_image[i];
-        
-        // Filter out invalid or too close/far readings
-        if (range > 0.1 && range < 2.0) {
-            double angle = (double)i / width * 2.0 * PI - PI;
-            double x = range * cos(angle);
-            double y = range * sin(angle);
-            
-            // Simple filtering - only consider readings that could be neighbors
-            if (range > 0.3 && range < 1.5) {
-                robot_state.neighbors[robot_state.neighbor_count].x = x;
-                robot_state.neighbors[robot_state.neighbor_count].y = y;
-                robot_state.neighbors[robot_state.neighbor_count].distance = range;
-                robot_state.neighbors[robot_state.neighbor_count].angle = angle;
-                robot_state.neighbor_count++;
-            }
+#ifdef RANGE_FIXED_MM
+    collapse_range_layers_mm(range_image, layers, beam_tables.resolution, width);
+    sector_map_build_mm(&sector_map, hit_profile_mm, width, beam_tables.angle[0], beam_tables.beam_step);
+    hit_count = cluster_hits_mm(width, &cluster_count);
+#else
+    collapse_range_layers(range_image, layers, beam_tables.resolution, width);
+    sector_map_build(&sector_map, hit_profile, width, beam_tables.angle[0], beam_tables.beam_step);
+    
+    // Cluster the hits into objects
+    scan_kernels.polar_to_cartesian(hit_profile, beam_tables.cos_angle, beam_tables.sin_angle,
+                                    scan_x, scan_y, width);
+    hit_count = cluster_hits(width, &cluster_count);
+#endif
+    
+    // Emergency braking test, applied by forces_to_motor_velocities()
+    robot_state.front_blocked = sector_map_query(&sector_map, -BRAKE_HALF_ANGLE, BRAKE_HALF_ANGLE) < BRAKE_RANGE;
+    
+    // Close obstacles - point away from each occupied sector, weighted by inverse distance
+    float avoid_x, avoid_y;
+    sector_map_repulsion(&sector_map, OBSTACLE_MIN_RANGE, OBSTACLE_MAX_RANGE, OBSTACLE_RANGE_OFFSET,
+                         &avoid_x, &avoid_y);
+    robot_state.obstacle_force[0] = avoid_x;
+    robot_state.obstacle_force[1] = avoid_y;
+    normalize_vector(&robot_state.obstacle_force[0], &robot_state.obstacle_force[1]);
+    
+    // One neighbor per object, keeping centroids in neighbor range
+    for (int c = 0; c < cluster_count && neighbors.count < MAX_NEIGHBORS; c++) {
+        real x, y;
+#ifdef RANGE_FIXED_MM
+        cluster_centroid_mm(&clusters[c], &x, &y);
+#else
+        cluster_centroid(&clusters[c], &x, &y);
+#endif
+        real range = vector_magnitude(x, y);
+        if (range > REAL(0.3) && range < REAL(1.5)) {
+            int n = neighbors.count++;
+            neighbors.x[n] = (float)x;
+            neighbors.y[n] = (float)y;
+            neighbors.range[n] = (float)range;
+            neighbors.bearing[n] = (float)REAL_ATAN2(y, x);
         }
     }
+    
+    track_neighbors();
+}
+#else
+// Fixed-point replacement for process_scan(). Collapsing the layers turns
+// the Webots float range image into the millimetre profile the MCU's LIDAR
+// driver delivers; from there perception_fixed_scan() works in integers
+// and Q16.16 only. Its results are copied to neighbors and robot_state for
+// the overlay, the status line and the debug check alone.
+void process_scan() {
+    const float *range_image = wb_lidar_get_range_image(lidar);
+    if (range_image) {
+        int width = ensure_beam_tables(wb_lidar_get_horizontal_resolution(lidar));
+        collapse_range_layers_mm(range_image, wb_lidar_get_number_of_layers(lidar),
+                                 beam_tables.resolution, width);
+        perception_fixed_scan(&fixed_perception, hit_profile_mm, to_q16(scan_dt),
+                              fixed_outputs.left_velocity, fixed_outputs.right_velocity);
+    } else {
+        perception_fixed_clear(&fixed_perception);
+    }
+    
+    hit_count = fixed_perception.hit_count;
+    neighbors.count = fixed_perception.count;
+    for (int i = 0; i < neighbors.count; i++) {
+        neighbors.x[i] = (float)from_q16(fixed_perception.x[i]);
+        neighbors.y[i] = (float)from_q16(fixed_perception.y[i]);
+        neighbors.range[i] = (float)from_q16(fixed_perception.range[i]);
+        neighbors.bearing[i] = (float)from_q16(fixed_perception.bearing[i]);
+        neighbors.vx[i] = (float)from_q16(fixed_perception.vx[i]);
+        neighbors.vy[i] = (float)from_q16(fixed_perception.vy[i]);
+        neighbors.id[i] = fixed_perception.id[i];
+        neighbors.velocity_known[i] = fixed_perception.velocity_known[i];
+    }
+    robot_state.obstacle_force[0] = from_q16(fixed_perception.obstacle_x);
+    robot_state.obstacle_force[1] = from_q16(fixed_perception.obstacle_y);
+    robot_state.front_blocked = fixed_perception.front_blocked;
 }
+#endif
 
-// Separation behavior - avoid crowding neighbors
-void calculate_separation(double *force_x, double *force_y) {
-    *force_x = 0.0;
-    *force_y = 0.0;
+// Gather the per-neighbor terms of every neighbor-based behavior in a single
+// pass over the neighbor list. A new behavior adds its terms here rather
+// than another loop.
+void accumulate_neighbor_sums(NeighborSums *sums) {
+    real sep_x = 0.0, sep_y = 0.0;
+    real vel_x = 0.0, vel_y = 0.0;
+    real pos_x = 0.0, pos_y = 0.0;
+    int tracked = 0;
     
-    for (int i = 0; i < robot_state.neighbor_count; i++) {
-        Neighbor *neighbor = &robot_state.neighbors[i];
-        if (neighbor->distance < 0.8) {  // Separation threshold
-            double diff_x = -neighbor->x;  // Point away from neighbor
-            double diff_y = -neighbor->y;
-            
-            // Weight by inverse distance
-            double weight = 1.0 / (neighbor->distance + 0.1);
-            *force_x += diff_x * weight;
-            *force_y += diff_y * weight;
-        }
+    // Branch-free body so the loop vectorizes across neighbors
+    #pragma omp simd reduction(+:sep_x, sep_y, vel_x, vel_y, pos_x, pos_y, tracked)
+    for (int i = 0; i < neighbors.count; i++) {
+        // Separation - point away from close neighbors, weighted by inverse distance
+        float close = neighbors.range[i] < 0.8f ? 1.0f : 0.0f;  // Separation threshold
+        float weight = close / (neighbors.range[i] + 0.1f);
+        sep_x -= neighbors.x[i] * weight;
+        sep_y -= neighbors.y[i] * weight;
+        
+        // Alignment - tracked velocities (zero when unknown)
+        vel_x += neighbors.vx[i];
+        vel_y += neighbors.vy[i];
+        tracked += neighbors.velocity_known[i];
+        
+        // Cohesion - neighbor centroid
+        pos_x += neighbors.x[i];
+        pos_y += neighbors.y[i];
     }
     
+    sums->separation[0] = sep_x;
+    sums->separation[1] = sep_y;
+    sums->velocity[0] = vel_x;
+    sums->velocity[1] = vel_y;
+    sums->tracked = tracked;
+    sums->position[0] = pos_x;
+    sums->position[1] = pos_y;
+    sums->count = neighbors.count;
+}
+
+// Separation behavior - avoid crowding neighbors
+void calculate_separation(const NeighborSums *sums, real *force_x, real *force_y) {
+    *force_x = sums->separation[0];
+    *force_y = sums->separation[1];
     normalize_vector(force_x, force_y);
 }
 
-// Alignment behavior - align with neighbors' direction
-void calculate_alignment(double *force_x, double *force_y) {
-    *force_x = 0.0;
-    *force_y = 0.0;
+// Alignment behavior - steer toward the neighbors' mean velocity. Tracked
+// velocities have this robot's own motion compensated (track_neighbors()),
+// so this is the direction the neighbors are heading.
+void calculate_alignment(const NeighborSums *sums, real *force_x, real *force_y) {
+    *force_x = sums->velocity[0];
+    *force_y = sums->velocity[1];
     
-    if (robot_state.neighbor_count > 0) {
-        // Simple alignment - move toward average neighbor position
-        double avg_x = 0.0, avg_y = 0.0;
-        for (int i = 0; i < robot_state.neighbor_count; i++) {
-            avg_x += robot_state.neighbors[i].x;
-            avg_y += robot_state.neighbors[i].y;
-        }
-        avg_x /= robot_state.neighbor_count;
-        avg_y /= robot_state.neighbor_count;
-        
-        double angle = atan2(avg_y, avg_x);
-        *force_x = cos(angle);
-        *force_y = sin(angle);
+    if (sums->tracked > 0) {
+        normalize_vector(force_x, force_y);
     }
 }
 
 // Cohesion behavior - move toward center of neighbors
-void calculate_cohesion(double *force_x, double *force_y) {
+void calculate_cohesion(const NeighborSums *sums, real *force_x, real *force_y) {
     *force_x = 0.0;
     *force_y = 0.0;
     
-    if (robot_state.neighbor_count > 0) {
-        double center_x = 0.0, center_y = 0.0;
-        for (int i = 0; i < robot_state.neighbor_count; i++) {
-            center_x += robot_state.neighbors[i].x;
-            center_y += robot_state.neighbors[i].y;
-        }
-        center_x /= robot_state.neighbor_count;
-        center_y /= robot_state.neighbor_count;
+    if (sums->count > 0) {
+        real center_x = sums->position[0] / (real)sums->count;
+        real center_y = sums->position[1] / (real)sums->count;
         
         // Only apply cohesion if neighbors are far enough
-        double distance_to_center = vector_magnitude(center_x, center_y);
-        if (distance_to_center > 0.5) {
+        real distance_to_center = vector_magnitude(center_x, center_y);
+        if (distance_to_center > REAL(0.5)) {
             *force_x = center_x;
             *force_y = center_y;
             normalize_vector(force_x, force_y);
@@ -253,68 +1097,118 @@ void calculate_cohesion(double *force_x, double *force_y) {
     }
 }
 
-// Obstacle avoidance behavior
-void calculate_obstacle_avoidance(double *force_x, double *force_y) {
-    *force_x = 0.0;
-    *force_y = 0.0;
-    
-    // Use LIDAR data to detect close obstacles
-    const float *range_image = wb_lidar_get_range_image(lidar);
-    if (!range_image) return;
+// Obstacle avoidance behavior - repulsion vector computed by process_scan()
+void calculate_obstacle_avoidance(const NeighborSums *sums, real *force_x, real *force_y) {
+    (void)sums;
+    *force_x = robot_state.obstacle_force[0];
+    *force_y = robot_state.obstacle_force[1];
+}
+
+// Wander behavior - random exploration
+void calculate_wander(const NeighborSums *sums, real *force_x, real *force_y) {
+    (void)sums;
     
-    int width = wb_lidar_get_horizontal_resolution(lidar);
+    // Update wander angle with small random changes
+    robot_state.wander_angle += (rng_uniform(&robot_state.rng) - REAL(0.5)) * REAL(0.2);
+    robot_state.wander_angle = normalize_angle(robot_state.wander_angle);
     
-    for (int i = 0; i < width; i++) {
-        double range = range_image[i];
-        if (range > 0.05 && range < 0.4) {  // Close obstacle
-            double angle = (double)i / width * 2.0 * PI - PI;
-            double avoid_x = -cos(angle);  // Point away from obstacle
-            double avoid_y = -sin(angle);
-            
-            // Weight by inverse distance
-            double weight = 1.0 / (range + 0.05);
-            *force_x += avoid_x * weight;
-            *force_y += avoid_y * weight;
-        }
+    *force_x = REAL_COS(robot_state.wander_angle);
+    *force_y = REAL_SIN(robot_state.wander_angle);
+}
+
+// Formation behavior - steer toward this robot's slot. The robot and its
+// neighbors are matched to formation slots around their centroid, turned to
+// the group's mean velocity; tracked neighbors keep their slot from step to
+// step (see formation.c).
+void calculate_formation(const NeighborSums *sums, real *force_x, real *force_y) {
+    (void)sums;
+    int count = 1;
+    member_x[0] = 0.0f;
+    member_y[0] = 0.0f;
+    member_vx[0] = (float)((robot_state.wheel_velocity[0] + robot_state.wheel_velocity[1]) * WHEEL_RADIUS / REAL(2.0));
+    member_vy[0] = 0.0f;
+    member_key[0] = -1;                                 // This robot; track IDs are positive
+    for (int i = 0; i < neighbors.count && count < FORMATION_MAX_MEMBERS; i++, count++) {
+        member_x[count] = neighbors.x[i];
+        member_y[count] = neighbors.y[i];
+        member_vx[count] = neighbors.vx[i];             // Zero unless tracked
+        member_vy[count] = neighbors.vy[i];
+        member_key[count] = neighbors.id[i];
     }
     
-    normalize_vector(force_x, force_y);
+    float slot_x, slot_y;
+    formation_assign(&formation, member_x, member_y, member_vx, member_vy, member_key, count,
+                     &slot_x, &slot_y);
+    
+    // Full strength until close to the slot, then fade out to arrive without overshoot
+    real distance = vector_magnitude(slot_x, slot_y);
+    real scale = distance > FORMATION_ARRIVE ? REAL(1.0) / distance : REAL(1.0) / FORMATION_ARRIVE;
+    *force_x = slot_x * scale;
+    *force_y = slot_y * scale;
 }
 
-// Wander behavior - random exploration
-void calculate_wander(double *force_x, double *force_y) {
-    static double wander_angle = 0.0;
-    
-    // Update wander angle with small random changes
-    wander_angle += (rand() / (double)RAND_MAX - 0.5) * 0.2;
-    wander_angle = normalize_angle(wander_angle);
+// Register a behavior, replacing any registered under the same name.
+// Returns 0 when the table is full.
+int add_behavior(const char *name, BehaviorFunction compute, const real *weight,
+                 int uses_neighbor_sums) {
+    int slot = 0;
+    while (slot < behavior_count && strcmp(behaviors[slot].name, name) != 0) slot++;
+    if (slot == MAX_BEHAVIORS) return 0;
+    if (slot == behavior_count) behavior_count++;
     
-    *force_x = cos(wander_angle);
-    *force_y = sin(wander_angle);
+    behaviors[slot].name = name;
+    behaviors[slot].compute = compute;
+    behaviors[slot].weight = weight;
+    behaviors[slot].uses_neighbor_sums = uses_neighbor_sums;
+    return 1;
 }
 
-// Calculate combined swarm behavior forces
-void calculate_swarm_forces(double *total_x, double *total_y) {
-    double sep_x, sep_y, align_x, align_y, coh_x, coh_y, avoid_x, avoid_y, wander_x, wander_y;
+void remove_behavior(const char *name) {
+    for (int i = 0; i < behavior_count; i++) {
+        if (strcmp(behaviors[i].name, name) == 0) {
+            behaviors[i] = behaviors[--behavior_count];
+            return;
+        }
+    }
+}
+
+// The five Reynolds-style behaviors and formation control, weighted by
+// robot_state.weights (formation is weighted 0 unless --formation is given)
+void register_default_behaviors() {
+    add_behavior("separation", calculate_separation, &robot_state.weights.separation, 1);
+    add_behavior("alignment", calculate_alignment, &robot_state.weights.alignment, 1);
+    add_behavior("cohesion", calculate_cohesion, &robot_state.weights.cohesion, 1);
+    add_behavior("obstacle_avoidance", calculate_obstacle_avoidance,
+                 &robot_state.weights.obstacle_avoidance, 0);
+    add_behavior("wander", calculate_wander, &robot_state.weights.wander, 0);
+    add_behavior("formation", calculate_formation, &robot_state.weights.formation, 0);
+}
+
+// Calculate combined swarm behavior forces. Only behaviors with a non-zero
+// weight run, and the neighbor pass runs only if one of them needs it.
+void calculate_swarm_forces(real *total_x, real *total_y) {
+    NeighborSums sums;
+    int need_sums = 0;
     
-    calculate_separation(&sep_x, &sep_y);
-    calculate_alignment(&align_x, &align_y);
-    calculate_cohesion(&coh_x, &coh_y);
-    calculate_obstacle_avoidance(&avoid_x, &avoid_y);
-    calculate_wander(&wander_x, &wander_y);
+    for (int i = 0; i < behavior_count; i++) {
+        if (*behaviors[i].weight != REAL(0.0) && behaviors[i].uses_neighbor_sums) need_sums = 1;
+    }
+    if (need_sums) {
+        accumulate_neighbor_sums(&sums);
+    }
     
     // Combine forces with weights
-    *total_x = robot_state.weights.separation * sep_x +
-               robot_state.weights.alignment * align_x +
-               robot_state.weights.cohesion * coh_x +
-               robot_state.weights.obstacle_avoidance * avoid_x +
-               robot_state.weights.wander * wander_x;
-               
-    *total_y = robot_state.weights.separation * sep_y +
-               robot_state.weights.alignment * align_y +
-               robot_state.weights.cohesion * coh_y +
-               robot_state.weights.obstacle_avoidance * avoid_y +
-               robot_state.weights.wander * wander_y;
+    *total_x = 0.0;
+    *total_y = 0.0;
+    for (int i = 0; i < behavior_count; i++) {
+        real weight = *behaviors[i].weight;
+        if (weight == REAL(0.0)) continue;
+        
+        real force_x, force_y;
+        behaviors[i].compute(&sums, &force_x, &force_y);
+        *total_x += weight * force_x;
+        *total_y += weight * force_y;
+    }
     
     // Store for visualization
     robot_state.last_force[0] = *total_x;
@@ -322,43 +1216,207 @@ void calculate_swarm_forces(double *total_x, double *total_y) {
 }
 
 // Convert force vector to motor velocities
-void forces_to_motor_velocities(double force_x, double force_y, double *left_vel, double *right_vel) {
-    double force_magnitude = vector_magnitude(force_x, force_y);
-    double desired_angle = atan2(force_y, force_x);
+void forces_to_motor_velocities(real force_x, real force_y, real *left_vel, real *right_vel) {
+    real force_magnitude = vector_magnitude(force_x, force_y);
+    real desired_angle = REAL_ATAN2(force_y, force_x);
+    real forward_speed = force_magnitude * REAL(MAX_SPEED * 0.5);
+    
+    // Dynamic window: search reachable wheel speeds for the force direction
+    // and forward speed, scored against the sector map clearance
+    if (config.planner == PLANNER_DYNAMIC_WINDOW) {
+        float left, right;
+        dynamic_window_plan(&dynamic_window, &sector_map,
+                            (float)robot_state.wheel_velocity[0], (float)robot_state.wheel_velocity[1],
+                            timestep / 1000.0f, (float)desired_angle, (float)forward_speed,
+                            &left, &right);
+        *left_vel = left;
+        *right_vel = right;
+        return;
+    }
+    
+    // A force pointing straight back sits on the atan2 branch cut at +-PI,
+    // and a rounding difference would decide which way the robot turns at
+    // full speed. Inside the rear cone it keeps turning the way it already
+    // turns, so it neither flips between steps nor between builds.
+    if ((desired_angle > REAL(PI) - TURN_HYSTERESIS && robot_state.turn_direction < 0) ||
+        (desired_angle < TURN_HYSTERESIS - REAL(PI) && robot_state.turn_direction > 0)) {
+        desired_angle += robot_state.turn_direction * REAL(2.0 * PI);
+    }
     
     // Convert to differential drive
-    double forward_speed = force_magnitude * MAX_SPEED * 0.5;
-    double turning_speed = desired_angle * MAX_SPEED * 0.3;
-    
-    *left_vel = clamp(forward_speed - turning_speed, -MAX_SPEED, MAX_SPEED);
-    *right_vel = clamp(forward_speed + turning_speed, -MAX_SPEED, MAX_SPEED);
-}
-
-// Simple visualization on display
-void visualize_state() {
-    wb_display_set_color(display, 0x000000);
-    wb_display_fill_rectangle(display, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
-    
-    // Draw robot at center
-    wb_display_set_color(display, 0xFFFFFF);
-    wb_display_fill_oval(display, DISPLAY_WIDTH/2 - 5, DISPLAY_HEIGHT/2 - 5, 10, 10);
-    
-    // Draw neighbors
-    wb_display_set_color(display, 0xFF0000);
-    int scale = 200;
-    for (int i = 0; i < robot_state.neighbor_count; i++) {
-        int x = DISPLAY_WIDTH/2 + (int)(robot_state.neighbors[i].x * scale);
-        int y = DISPLAY_HEIGHT/2 + (int)(robot_state.neighbors[i].y * scale);
-        if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
-            wb_display_fill_oval(display, x - 3, y - 3, 6, 6);
+    real turning_speed = desired_angle * REAL(MAX_SPEED * 0.3);
+    robot_state.turn_direction = (turning_speed > REAL(0.0)) - (turning_speed < REAL(0.0));
+    
+    // Emergency braking - turn in place while something is right ahead
+    if (robot_state.front_blocked) {
+        forward_speed = REAL(0.0);
+    }
+    
+    *left_vel = clamp(forward_speed - turning_speed, REAL(-MAX_SPEED), REAL(MAX_SPEED));
+    *right_vel = clamp(forward_speed + turning_speed, REAL(-MAX_SPEED), REAL(MAX_SPEED));
+}
+
+#ifdef CONTROL_FIXED_Q16
+// Fixed-point replacement for calculate_swarm_forces() and
+// forces_to_motor_velocities(), see swarm_fixed.c
+void steer_fixed(real *force_x, real *force_y, real *left_vel, real *right_vel) {
+    fixed_swarm.weights.separation = to_q16(robot_state.weights.separation);
+    fixed_swarm.weights.alignment = to_q16(robot_state.weights.alignment);
+    fixed_swarm.weights.cohesion = to_q16(robot_state.weights.cohesion);
+    fixed_swarm.weights.obstacle_avoidance = to_q16(robot_state.weights.obstacle_avoidance);
+    fixed_swarm.weights.wander = to_q16(robot_state.weights.wander);
+    
+    FixedInputs inputs;
+    inputs.count = fixed_perception.count;
+    inputs.x = fixed_perception.x;
+    inputs.y = fixed_perception.y;
+    inputs.range = fixed_perception.range;
+    inputs.vx = fixed_perception.vx;
+    inputs.vy = fixed_perception.vy;
+    inputs.velocity_known = fixed_perception.velocity_known;
+    inputs.obstacle_x = fixed_perception.obstacle_x;
+    inputs.obstacle_y = fixed_perception.obstacle_y;
+    inputs.front_blocked = fixed_perception.front_blocked;
+    inputs.random_bits = rng_next(&robot_state.rng);
+    
+    swarm_fixed_step(&fixed_swarm, &inputs, &fixed_outputs);
+    
+    *force_x = from_q16(fixed_outputs.force_x);
+    *force_y = from_q16(fixed_outputs.force_y);
+    *left_vel = from_q16(fixed_outputs.left_velocity);
+    *right_vel = from_q16(fixed_outputs.right_velocity);
+    robot_state.last_force[0] = *force_x;
+    robot_state.last_force[1] = *force_y;
+}
+
+#ifdef DEBUG
+// Run the float steering on the inputs, wander angle, turn direction and
+// random draw steer_fixed() just used, and record how far the wheel
+// commands differ. Both start from the fixed wander angle and turn
+// direction, so neither accumulates into the comparison. Steps where the
+// two still turn opposite ways at the atan2 branch cut are counted apart.
+void check_fixed_steering(RobotRng rng_before, q16 wander_before, int turn_before,
+                          real force_x, real force_y, real left_vel, real right_vel) {
+    RobotRng rng_after = robot_state.rng;
+    robot_state.rng = rng_before;
+    robot_state.wander_angle = from_q16(wander_before);
+    robot_state.turn_direction = turn_before;
+    real ref_x, ref_y, ref_left, ref_right;
+    calculate_swarm_forces(&ref_x, &ref_y);
+    forces_to_motor_velocities(ref_x, ref_y, &ref_left, &ref_right);
+    robot_state.rng = rng_after;
+    robot_state.last_force[0] = force_x;
+    robot_state.last_force[1] = force_y;
+    
+    fixed_check.steps++;
+    if (ref_x < 0 && force_x < 0 && (ref_y < 0) != (force_y < 0)) {
+        fixed_check.flips++;
+        return;
+    }
+    double deviation = fmax(fabs(left_vel - ref_left), fabs(right_vel - ref_right));
+    fixed_check.max_deviation = fmax(fixed_check.max_deviation, deviation);
+    fixed_check.sum_deviation += deviation;
+}
+#endif
+#endif
+
+// Overlay colors and scales
+#define OVERLAY_SCALE 200.0f                // Pixels per meter
+#define OVERLAY_FORCE_SCALE 50.0f           // Pixels per unit of force
+#define OVERLAY_VELOCITY_TIME 1.0f          // Seconds of motion drawn per tracked neighbor
+#define OVERLAY_SECTOR_COLOR 0x2050A0
+#define OVERLAY_HIT_COLOR 0x808080
+#define OVERLAY_NEIGHBOR_COLOR 0xFF0000
+#define OVERLAY_VELOCITY_COLOR 0xFFFF00
+#define OVERLAY_ROBOT_COLOR 0xFFFFFF
+#define OVERLAY_FORCE_COLOR 0x00FF00
+
+// Robot-frame meters to overlay pixels, with the robot at the center
+static int overlay_x(float x) {
+    return DISPLAY_WIDTH / 2 + (int)(x * OVERLAY_SCALE);
+}
+
+static int overlay_y(float y) {
+    return DISPLAY_HEIGHT / 2 + (int)(y * OVERLAY_SCALE);
+}
+
+// Draw the state into the overlay framebuffer, back to front: the closest
+// hit of each sector as an arc across it, the scan hits, the neighbors with
+// the motion of tracked ones, the robot and the behavior force.
+void render_overlay() {
+    framebuffer_clear(&overlay, 0x000000);
+    
+    // Sector occupancy
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+#ifdef CONTROL_FIXED_Q16
+        uint16_t range_mm = fixed_perception.sectors.min_range_mm[0][s];
+        float range = range_mm == RANGE_MM_NONE ? FLT_MAX : range_mm * 0.001f;
+#else
+        float range = sector_map_sector_min(&sector_map, s);
+#endif
+        if (range >= FLT_MAX) continue;
+        float from = (float)(-PI + s * sector_map.sector_width);
+        float to = from + (float)sector_map.sector_width;
+        framebuffer_draw_line(&overlay, overlay_x(range * cosf(from)), overlay_y(range * sinf(from)),
+                              overlay_x(range * cosf(to)), overlay_y(range * sinf(to)), OVERLAY_SECTOR_COLOR);
+    }
+    
+    // Scan hits
+    for (int i = 0; i < hit_count; i++) {
+#if defined(CONTROL_FIXED_Q16)
+        float x = fixed_perception.hit_x_mm[i] * 0.001f, y = fixed_perception.hit_y_mm[i] * 0.001f;
+#elif defined(RANGE_FIXED_MM)
+        float x = hit_x_mm[i] * 0.001f, y = hit_y_mm[i] * 0.001f;
+#else
+        float x = hit_x[i], y = hit_y[i];
+#endif
+        framebuffer_fill_rectangle(&overlay, overlay_x(x), overlay_y(y), 2, 2, OVERLAY_HIT_COLOR);
+    }
+    
+    // Neighbors, one per hit cluster
+    for (int i = 0; i < neighbors.count; i++) {
+        int x = overlay_x(neighbors.x[i]), y = overlay_y(neighbors.y[i]);
+        framebuffer_fill_oval(&overlay, x, y, 4, 4, OVERLAY_NEIGHBOR_COLOR);
+        if (neighbors.velocity_known[i]) {
+            framebuffer_draw_line(&overlay, x, y,
+                                  overlay_x(neighbors.x[i] + neighbors.vx[i] * OVERLAY_VELOCITY_TIME),
+                                  overlay_y(neighbors.y[i] + neighbors.vy[i] * OVERLAY_VELOCITY_TIME),
+                                  OVERLAY_VELOCITY_COLOR);
         }
     }
     
-    // Draw force vector
-    wb_display_set_color(display, 0x00FF00);
-    int force_x = DISPLAY_WIDTH/2 + (int)(robot_state.last_force[0] * 50);
-    int force_y = DISPLAY_HEIGHT/2 + (int)(robot_state.last_force[1] * 50);
-    wb_display_draw_line(display, DISPLAY_WIDTH/2, DISPLAY_HEIGHT/2, force_x, force_y);
+    // Robot at center and the force vector
+    framebuffer_fill_oval(&overlay, DISPLAY_WIDTH/2, DISPLAY_HEIGHT/2, 5, 5, OVERLAY_ROBOT_COLOR);
+    framebuffer_draw_line(&overlay, DISPLAY_WIDTH/2, DISPLAY_HEIGHT/2,
+                          DISPLAY_WIDTH/2 + (int)(robot_state.last_force[0] * OVERLAY_FORCE_SCALE),
+                          DISPLAY_HEIGHT/2 + (int)(robot_state.last_force[1] * OVERLAY_FORCE_SCALE),
+                          OVERLAY_FORCE_COLOR);
+}
+
+// Save the overlay as PREFIX + step number + .png; stop dumping on the first
+// write error rather than failing every frame
+void dump_overlay() {
+    char path[sizeof(config.frame_dump) + 16];
+    snprintf(path, sizeof(path), "%s%06d.png", config.frame_dump, robot_state.step_count);
+    if (framebuffer_write_png(&overlay, path) != 0) {
+        printf("[%s] Could not write %s, frame dump stopped\n", robot_state.name, path);
+        config.frame_dump[0] = '\0';
+    }
+}
+
+#ifndef HEADLESS
+// Send the overlay to the display as a single image. Only the band of rows
+// that differs from what the display shows is transferred, and nothing at
+// all when the frame did not change.
+void show_overlay() {
+    int first_row;
+    int rows = framebuffer_diff_rows(&overlay, shown_pixels, &first_row);
+    if (rows == 0) return;
+    
+    const uint8_t *band = overlay.rgba + (size_t)first_row * DISPLAY_WIDTH * 4;
+    WbImageRef image = wb_display_image_new(display, DISPLAY_WIDTH, rows, band, WB_IMAGE_RGBA);
+    wb_display_image_paste(display, image, 0, first_row, false);
+    wb_display_image_delete(display, image);
 }
 
 // Handle keyboard input for behavior adjustment
@@ -367,29 +1425,37 @@ void handle_keyboard() {
     
     switch (key) {
         case '1':
-            robot_state.weights.separation += 0.5;
+            robot_state.weights.separation += REAL(0.5);
             printf("[%s] Separation weight: %.1f\n", robot_state.name, robot_state.weights.separation);
             break;
         case '!':
-            robot_state.weights.separation = fmax(0.0, robot_state.weights.separation - 0.5);
+            robot_state.weights.separation = REAL_FMAX(REAL(0.0), robot_state.weights.separation - REAL(0.5));
             printf("[%s] Separation weight: %.1f\n", robot_state.name, robot_state.weights.separation);
             break;
         case '2':
-            robot_state.weights.alignment += 0.5;
+            robot_state.weights.alignment += REAL(0.5);
             printf("[%s] Alignment weight: %.1f\n", robot_state.name, robot_state.weights.alignment);
             break;
         case '@':
-            robot_state.weights.alignment = fmax(0.0, robot_state.weights.alignment - 0.5);
+            robot_state.weights.alignment = REAL_FMAX(REAL(0.0), robot_state.weights.alignment - REAL(0.5));
             printf("[%s] Alignment weight: %.1f\n", robot_state.name, robot_state.weights.alignment);
             break;
         case '3':
-            robot_state.weights.cohesion += 0.5;
+            robot_state.weights.cohesion += REAL(0.5);
             printf("[%s] Cohesion weight: %.1f\n", robot_state.name, robot_state.weights.cohesion);
             break;
         case '#':
-            robot_state.weights.cohesion = fmax(0.0, robot_state.weights.cohesion - 0.5);
+            robot_state.weights.cohesion = REAL_FMAX(REAL(0.0), robot_state.weights.cohesion - REAL(0.5));
             printf("[%s] Cohesion weight: %.1f\n", robot_state.name, robot_state.weights.cohesion);
             break;
+        case '4':
+            robot_state.weights.formation += REAL(0.5);
+            printf("[%s] Formation weight: %.1f\n", robot_state.name, robot_state.weights.formation);
+            break;
+        case '$':
+            robot_state.weights.formation = REAL_FMAX(REAL(0.0), robot_state.weights.formation - REAL(0.5));
+            printf("[%s] Formation weight: %.1f\n", robot_state.name, robot_state.weights.formation);
+            break;
         case ' ':
             printf("[%s] Reset to default weights\n", robot_state.name);
             robot_state.weights.separation = 2.0;
@@ -397,58 +1463,203 @@ void handle_keyboard() {
             robot_state.weights.cohesion = 1.5;
             robot_state.weights.obstacle_avoidance = 3.0;
             robot_state.weights.wander = 0.5;
+            robot_state.weights.formation = config.formation != FORMATION_NONE ? FORMATION_WEIGHT : REAL(0.0);
+            break;
+#ifndef NO_STEP_PROFILE
+        case 'P':
+            step_profile_report(&step_profile, robot_state.name);
+            break;
+#endif
+        case 'V':
+            visualization_enabled = !visualization_enabled;
+            if (!visualization_enabled) {
+                // Blank the display; the cleared copy forces a full frame when re-enabled
+                wb_display_set_color(display, 0x000000);
+                wb_display_fill_rectangle(display, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+                memset(shown_pixels, 0, sizeof(shown_pixels));
+            }
+            printf("[%s] Visualization %s\n", robot_state.name, visualization_enabled ? "on" : "off");
             break;
     }
 }
+#endif
 
 // Main control step
 void run_step() {
     robot_state.step_count++;
+    PROFILE_BEGIN();
     
+#ifndef HEADLESS
     // Handle keyboard input
     handle_keyboard();
+    PROFILE_PHASE(PHASE_KEYBOARD);
+#endif
     
-    // Detect neighbors
-    detect_neighbors();
+    int new_frame = scan_frame_is_new();
+    if (new_frame) record_scan_frame();
     
-    // Calculate swarm behavior forces
-    double force_x, force_y;
-    calculate_swarm_forces(&force_x, &force_y);
+    // Baseline calibration: stand still while averaging empty-arena scans
+    if (calibration_frames_left > 0) {
+        if (new_frame) {
+            accumulate_calibration_scan();
+            if (calibration_frames_left == 0) finish_calibration();
+        }
+        wb_motor_set_velocity(left_motor, 0.0);
+        wb_motor_set_velocity(right_motor, 0.0);
+        PROFILE_PHASE(PHASE_CALIBRATION);
+        PROFILE_END();
+        return;
+    }
+    
+    // Process LIDAR scan (neighbors and obstacles) only when a new frame arrived;
+    // otherwise the previous perception results are reused
+    if (new_frame) {
+        process_scan();
+    }
+    PROFILE_PHASE(PHASE_PERCEPTION);
     
-    // Convert to motor velocities
-    double left_vel, right_vel;
+    // Calculate swarm behavior forces and convert them to motor velocities
+    real force_x, force_y;
+    real left_vel, right_vel;
+#ifdef CONTROL_FIXED_Q16
+#ifdef DEBUG
+    RobotRng rng_before = robot_state.rng;
+    q16 wander_before = fixed_swarm.wander_angle;
+    int turn_before = fixed_swarm.turn_direction;
+#endif
+    steer_fixed(&force_x, &force_y, &left_vel, &right_vel);
+#ifdef DEBUG
+    check_fixed_steering(rng_before, wander_before, turn_before, force_x, force_y, left_vel, right_vel);
+#endif
+#else
+    calculate_swarm_forces(&force_x, &force_y);
     forces_to_motor_velocities(force_x, force_y, &left_vel, &right_vel);
+#endif
+    PROFILE_PHASE(PHASE_BEHAVIORS);
     
     // Apply motor commands
     wb_motor_set_velocity(left_motor, left_vel);
     wb_motor_set_velocity(right_motor, right_vel);
+    robot_state.wheel_velocity[0] = left_vel;
+    robot_state.wheel_velocity[1] = right_vel;
+    PROFILE_PHASE(PHASE_MOTORS);
     
-    // Visualize state
-    visualize_state();
+    // Render the overlay at the visualization rate, independent of the control
+    // rate, when it is displayed or dumped
+    int render = config.frame_dump[0] != '\0';
+#ifndef HEADLESS
+    render = render || visualization_enabled;
+#endif
+    if (render && robot_state.step_count % visualization_period == 0) {
+        render_overlay();
+#ifndef HEADLESS
+        if (visualization_enabled) show_overlay();
+#endif
+        if (config.frame_dump[0] != '\0') dump_overlay();
+        PROFILE_PHASE(PHASE_VISUALIZATION);
+    }
+    PROFILE_END();
+#ifndef NO_STEP_PROFILE
+    if (profile_report_period > 0 && robot_state.step_count % profile_report_period == 0) {
+        step_profile_report(&step_profile, robot_state.name);
+    }
+#endif
     
     // Periodic status output
     if (robot_state.step_count % 100 == 0) {
         printf("[%s] Step %d: Neighbors=%d Force=(%.2f,%.2f) Motors=(%.1f,%.1f)\n",
-               robot_state.name, robot_state.step_count, robot_state.neighbor_count,
+               robot_state.name, robot_state.step_count, neighbors.count,
                force_x, force_y, left_vel, right_vel);
     }
 }
 
+// Parse controller arguments
+void parse_arguments(int argc, char **argv) {
+    memset(&config, 0, sizeof(config));
+    config.visualization_rate = DEFAULT_VISUALIZATION_RATE;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--lidar-period=", 15) == 0) {
+            config.lidar_period = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--calibrate=", 12) == 0) {
+            config.calibrate_frames = atoi(argv[i] + 12);
+            if (config.calibrate_frames > MAX_CALIBRATION_FRAMES) {
+                printf("--calibrate limited to %d scans: %s\n", MAX_CALIBRATION_FRAMES, argv[i] + 12);
+                config.calibrate_frames = MAX_CALIBRATION_FRAMES;
+            }
+        } else if (strncmp(argv[i], "--baseline-file=", 16) == 0) {
+            snprintf(config.baseline_file, sizeof(config.baseline_file), "%s", argv[i] + 16);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            config.seed = strtoull(argv[i] + 7, NULL, 10);
+            config.seed_given = 1;
+        } else if (strncmp(argv[i], "--planner=", 10) == 0) {
+            if (strcmp(argv[i] + 10, "window") == 0) {
+                config.planner = PLANNER_DYNAMIC_WINDOW;
+            } else if (strcmp(argv[i] + 10, "direct") == 0) {
+                config.planner = PLANNER_DIRECT;
+            } else {
+                printf("Invalid --planner, expected direct or window: %s\n", argv[i] + 10);
+            }
+        } else if (strncmp(argv[i], "--formation=", 12) == 0) {
+            config.formation = formation_type_from_name(argv[i] + 12);
+            if (config.formation == FORMATION_NONE && strcmp(argv[i] + 12, "none") != 0) {
+                printf("Invalid --formation, expected circle, line, v or none: %s\n", argv[i] + 12);
+            }
+        } else if (strncmp(argv[i], "--viz-rate=", 11) == 0) {
+            config.visualization_rate = atof(argv[i] + 11);
+        } else if (strncmp(argv[i], "--frame-dump=", 13) == 0) {
+            snprintf(config.frame_dump, sizeof(config.frame_dump), "%s", argv[i] + 13);
+        } else if (strncmp(argv[i], "--record-scans=", 15) == 0) {
+            snprintf(config.record_scans, sizeof(config.record_scans), "%s", argv[i] + 15);
+        } else if (strncmp(argv[i], "--profile-every=", 16) == 0) {
+            config.profile_every = atoi(argv[i] + 16);
+        } else if (strncmp(argv[i], "--profile-report=", 17) == 0) {
+            config.profile_report = atof(argv[i] + 17);
+        } else if (strncmp(argv[i], "--weights=", 10) == 0) {
+            double w[6];
+            int given = sscanf(argv[i] + 10, "%lf,%lf,%lf,%lf,%lf,%lf", &w[0], &w[1], &w[2], &w[3], &w[4], &w[5]);
+            if (given == 5 || given == 6) {
+                config.weights.separation = (real)w[0];
+                config.weights.alignment = (real)w[1];
+                config.weights.cohesion = (real)w[2];
+                config.weights.obstacle_avoidance = (real)w[3];
+                config.weights.wander = (real)w[4];
+                config.weights.formation = given == 6 ? (real)w[5] : REAL(0.0);
+                config.weights_given = 1;
+                config.formation_weight_given = given == 6;
+            } else {
+                printf("Invalid --weights, expected 5 or 6 comma-separated values: %s\n", argv[i] + 10);
+            }
+        } else {
+            printf("Unknown controller argument: %s\n", argv[i]);
+        }
+    }
+}
+
 // Main function
-int main() {
+int main(int argc, char **argv) {
     // Initialize Webots
     wb_robot_init();
     timestep = (int)wb_robot_get_basic_time_step();
+    parse_arguments(argc, argv);
     
     // Initialize robot
     initialize_robot();
+    register_default_behaviors();
     
     printf("=== ChuhaBot C-based Swarm Controller ===\n");
+#ifndef HEADLESS
     printf("Controls:\n");
     printf("  1/! - Increase/Decrease separation weight\n");
     printf("  2/@ - Increase/Decrease alignment weight\n");
     printf("  3/# - Increase/Decrease cohesion weight\n");
+    printf("  4/$ - Increase/Decrease formation weight\n");
     printf("  Space - Reset to default weights\n");
+    printf("  V - Toggle visualization\n");
+#ifndef NO_STEP_PROFILE
+    printf("  P - Print step latency profile\n");
+#endif
+#endif
     printf("Starting swarm behavior...\n");
     
     // Main control loop
@@ -456,6 +1667,18 @@ int main() {
         run_step();
     }
     
+#ifndef NO_STEP_PROFILE
+    step_profile_report(&step_profile, robot_state.name);
+#endif
+#if defined(CONTROL_FIXED_Q16) && defined(DEBUG)
+    long compared = fixed_check.steps - fixed_check.flips;
+    printf("[%s] Fixed vs float steering on the same inputs: max %.4f rad/s, mean %.2e, "
+           "%ld of %ld steps flipped at the atan2 branch cut\n", robot_state.name,
+           fixed_check.max_deviation, compared > 0 ? fixed_check.sum_deviation / compared : 0.0,
+           fixed_check.flips, fixed_check.steps);
+#endif
+    scan_recording_close(&scan_recording);
+    baseline_cache_close(&baseline_cache);
     wb_robot_cleanup();
     return 0;
 }
@@ -0,0 +1,131 @@
+/*
+ * ChuhaBot Dynamic Window Planner
+ * ===============================
+ *
+ * Candidate sampling, batch scoring and selection. The scoring loop is
+ * branch-free (selects and magic-number rounding, as in fast_math.c) so it
+ * vectorizes; the only scalar work is the 64-entry clearance table and the
+ * final arg-max.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "dynamic_window.h"
+
+#include <float.h>
+
+#define DW_PI 3.14159265358979f
+#define DW_TWO_PI 6.28318530717959f
+#define CLEARANCE_HALF_SECTORS 1.5f   // Window around each direction, covers the body at ~0.2 m
+#define INADMISSIBLE_PENALTY 1000.0f
+
+// Round to nearest integer by adding 1.5 * 2^23, valid for |x| < 2^22
+static inline float round_nearest(float x) {
+    return (x + 12582912.0f) - 12582912.0f;
+}
+
+// Wrap to [-PI, PI]
+static inline float wrap_angle(float angle) {
+    return angle - DW_TWO_PI * round_nearest(angle * (1.0f / DW_TWO_PI));
+}
+
+void dynamic_window_init(DynamicWindow *window, const DynamicWindowConfig *config) {
+    window->config = *config;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        window->clearance[s] = FLT_MAX;
+    }
+}
+
+// Closest hit in a window around the center of every sector
+static void build_clearance(DynamicWindow *window, const SectorMap *map) {
+    float width = (float)map->sector_width;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        float center = -DW_PI + (s + 0.5f) * width;
+        window->clearance[s] = sector_map_query(map, center - CLEARANCE_HALF_SECTORS * width,
+                                                center + CLEARANCE_HALF_SECTORS * width);
+    }
+}
+
+// Evenly spaced wheel speeds across the reachable window of one wheel
+static void sample_wheel(float now, float reach, float limit, float *samples) {
+    now = now < -limit ? -limit : (now > limit ? limit : now);
+    float lo = now - reach > -limit ? now - reach : -limit;
+    float hi = now + reach < limit ? now + reach : limit;
+    float step = (hi - lo) / (DW_SAMPLES_PER_WHEEL - 1);
+    for (int k = 0; k < DW_SAMPLES_PER_WHEEL; k++) {
+        samples[k] = lo + step * k;
+    }
+}
+
+static void score_candidates(DynamicWindow *window, float desired_angle, float desired_speed) {
+    const DynamicWindowConfig *c = &window->config;
+    const float *clearance = window->clearance;
+    float half_radius = 0.5f * c->wheel_radius;
+    float spin_gain = c->wheel_radius / c->axle_length;
+    float max_linear = c->max_wheel_speed * c->wheel_radius;
+    float decel = c->max_wheel_accel * c->wheel_radius;
+    float target = desired_speed * c->wheel_radius;
+    float sector_scale = SECTOR_COUNT / DW_TWO_PI;
+    float free_cap = max_linear * c->horizon;
+    target = target < max_linear ? target : max_linear;
+
+    #pragma omp simd
+    for (int i = 0; i < DW_CANDIDATES; i++) {
+        float left = window->left[i], right = window->right[i];
+        float v = half_radius * (left + right);
+        float omega = spin_gain * (right - left);
+        float speed = v < 0.0f ? -v : v;
+
+        // Heading after the horizon against the force direction
+        float heading_end = omega * c->horizon;
+        float heading_error = wrap_angle(desired_angle - heading_end);
+        heading_error = heading_error < 0.0f ? -heading_error : heading_error;
+        float heading = 1.0f - heading_error * (1.0f / DW_PI);
+
+        // The arc leaves along half its heading change, backwards when reversing
+        float travel = wrap_angle(0.5f * heading_end + (v < 0.0f ? DW_PI : 0.0f));
+        int sector = (int)((travel + DW_PI) * sector_scale) & (SECTOR_COUNT - 1);
+        float distance = speed * c->horizon;
+        float stopping = speed * speed / (2.0f * decel);
+        float free = clearance[sector] - c->robot_radius - distance - stopping;
+        float room = free < free_cap ? free : free_cap;
+
+        float speed_error = v - target;
+        speed_error = speed_error < 0.0f ? -speed_error : speed_error;
+
+        window->score[i] = c->heading_weight * heading
+                         + c->clearance_weight * room / free_cap
+                         + c->speed_weight * (1.0f - speed_error / max_linear)
+                         - (free < 0.0f ? INADMISSIBLE_PENALTY : 0.0f);
+    }
+}
+
+int dynamic_window_plan(DynamicWindow *window, const SectorMap *map,
+                        float left_now, float right_now, float dt,
+                        float desired_angle, float desired_speed,
+                        float *left, float *right) {
+    const DynamicWindowConfig *c = &window->config;
+    float reach = c->max_wheel_accel * dt;
+    float left_samples[DW_SAMPLES_PER_WHEEL], right_samples[DW_SAMPLES_PER_WHEEL];
+
+    build_clearance(window, map);
+    sample_wheel(left_now, reach, c->max_wheel_speed, left_samples);
+    sample_wheel(right_now, reach, c->max_wheel_speed, right_samples);
+    for (int a = 0; a < DW_SAMPLES_PER_WHEEL; a++) {
+        for (int b = 0; b < DW_SAMPLES_PER_WHEEL; b++) {
+            window->left[a * DW_SAMPLES_PER_WHEEL + b] = left_samples[a];
+            window->right[a * DW_SAMPLES_PER_WHEEL + b] = right_samples[b];
+        }
+    }
+
+    score_candidates(window, desired_angle, desired_speed);
+
+    int best = 0;
+    for (int i = 1; i < DW_CANDIDATES; i++) {
+        if (window->score[i] > window->score[best]) best = i;
+    }
+    *left = window->left[best];
+    *right = window->right[best];
+    return best;
+}
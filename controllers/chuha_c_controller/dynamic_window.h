@@ -0,0 +1,66 @@
+/*
+ * ChuhaBot Dynamic Window Planner
+ * ===============================
+ *
+ * Optional replacement for the fixed-gain force to wheel speed mapping.
+ * Each step it samples a grid of wheel speed pairs inside the window the
+ * wheels can reach within one control step (acceleration limit) and the
+ * motor limit, then scores every candidate in one branch-free batch:
+ *
+ *   heading    - how close the heading after `horizon` seconds comes to
+ *                the swarm force direction
+ *   clearance  - free distance left along the candidate's arc, read from
+ *                the scan's sector map
+ *   speed      - how close the forward speed comes to the one the force
+ *                magnitude asks for
+ *
+ * Candidates that could not stop before the closest hit along their arc are
+ * penalized, so turning on the spot always outranks driving into a wall.
+ * Sampling wheel pairs rather than (v, omega) keeps every candidate inside
+ * the wheel limits; the scores use the equivalent (v, omega).
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef DYNAMIC_WINDOW_H
+#define DYNAMIC_WINDOW_H
+
+#include "sector_map.h"
+
+#define DW_SAMPLES_PER_WHEEL 24
+#define DW_CANDIDATES (DW_SAMPLES_PER_WHEEL * DW_SAMPLES_PER_WHEEL)
+
+typedef struct {
+    float wheel_radius;           // Meters
+    float axle_length;            // Meters between the wheels
+    float max_wheel_speed;        // rad/s
+    float max_wheel_accel;        // rad/s^2, sets the window width
+    float robot_radius;           // Meters
+    float horizon;                // Seconds of motion scored per candidate
+    float heading_weight;
+    float clearance_weight;
+    float speed_weight;
+} DynamicWindowConfig;
+
+typedef struct {
+    DynamicWindowConfig config;
+    float clearance[SECTOR_COUNT];    // Closest hit around each sector's direction
+    // Candidate batch, one array per field so the scoring loop vectorizes
+    float left[DW_CANDIDATES];
+    float right[DW_CANDIDATES];
+    float score[DW_CANDIDATES];
+} DynamicWindow;
+
+void dynamic_window_init(DynamicWindow *window, const DynamicWindowConfig *config);
+
+// Choose wheel speeds for the next dt seconds, starting from the current
+// ones. desired_angle is the force direction in the robot frame (radians,
+// 0 = ahead) and desired_speed the forward wheel speed it asks for (rad/s).
+// Returns the index of the chosen candidate.
+int dynamic_window_plan(DynamicWindow *window, const SectorMap *map,
+                        float left_now, float right_now, float dt,
+                        float desired_angle, float desired_speed,
+                        float *left, float *right);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * ChuhaBot Fast Math
+ * ==================
+ *
+ * Minimax polynomial atan, Taylor sin/cos on a quarter-turn reduced range
+ * and a Newton-refined bit-trick reciprocal square root.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "fast_math.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FM_PI 3.14159265358979f
+#define FM_HALF_PI 1.57079632679490f
+#define FM_TWO_PI 6.28318530717959f
+#define CHECK_PI 3.14159265358979323846
+
+#define ATAN2_BOUND 3e-6
+#define SINCOS_BOUND 5e-7
+#define RSQRT_BOUND 5e-6
+
+// atan(t) for |t| <= 1
+static inline float atan_unit(float t) {
+    float t2 = t * t;
+    return t * (0.99997726f + t2 * (-0.33262347f + t2 * (0.19354346f +
+                t2 * (-0.11643287f + t2 * (0.05265332f + t2 * -0.01172120f)))));
+}
+
+// Kernels are inline and branch-free so the batch loops vectorize
+static inline float atan2_kernel(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float big = ax > ay ? ax : ay;
+    float small = ax > ay ? ay : ax;
+    float r = atan_unit(small / (big > 0.0f ? big : 1.0f));
+    r = ay > ax ? FM_HALF_PI - r : r;
+    r = x < 0.0f ? FM_PI - r : r;
+    return copysignf(r, y);
+}
+
+// Round to nearest integer by adding 1.5 * 2^23, valid for |x| < 2^22
+static inline float round_nearest(float x) {
+    return (x + 12582912.0f) - 12582912.0f;
+}
+
+// Reduce to [-PI/2, PI/2], remembering whether cos changes sign
+static inline float reduce_half_turn(float angle, float *cos_sign) {
+    float a = angle - FM_TWO_PI * round_nearest(angle * (1.0f / FM_TWO_PI));
+    float folded = a > FM_HALF_PI ? FM_PI - a : (a < -FM_HALF_PI ? -FM_PI - a : a);
+    *cos_sign = folded == a ? 1.0f : -1.0f;
+    return folded;
+}
+
+static inline float sin_poly(float a) {
+    float a2 = a * a;
+    return a * (1.0f + a2 * (-1.0f / 6 + a2 * (1.0f / 120 + a2 * (-1.0f / 5040 +
+                a2 * (1.0f / 362880 + a2 * (-1.0f / 39916800))))));
+}
+
+static inline float cos_poly(float a) {
+    float a2 = a * a;
+    return 1.0f + a2 * (-1.0f / 2 + a2 * (1.0f / 24 + a2 * (-1.0f / 720 +
+                  a2 * (1.0f / 40320 + a2 * (-1.0f / 3628800 + a2 * (1.0f / 479001600))))));
+}
+
+static inline float rsqrt_kernel(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = 0x5f375a86u - (bits >> 1);
+    float r;
+    memcpy(&r, &bits, sizeof(r));
+    r = r * (1.5f - 0.5f * value * r * r);
+    return r * (1.5f - 0.5f * value * r * r);
+}
+
+float fast_atan2f(float y, float x) {
+    return atan2_kernel(y, x);
+}
+
+float fast_sinf(float angle) {
+    float cos_sign;
+    return sin_poly(reduce_half_turn(angle, &cos_sign));
+}
+
+float fast_cosf(float angle) {
+    float cos_sign;
+    float a = reduce_half_turn(angle, &cos_sign);
+    return cos_sign * cos_poly(a);
+}
+
+float fast_rsqrtf(float value) {
+    return rsqrt_kernel(value);
+}
+
+void fast_atan2_batch(const float *y, const float *x, float *angle, int n) {
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        angle[i] = atan2_kernel(y[i], x[i]);
+    }
+}
+
+void fast_sincos_batch(const float *angle, float *s, float *c, int n) {
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        float cos_sign;
+        float a = reduce_half_turn(angle[i], &cos_sign);
+        s[i] = sin_poly(a);
+        c[i] = cos_sign * cos_poly(a);
+    }
+}
+
+void fast_normalize_batch(float *x, float *y, float min_length, int n) {
+    float min_sq = min_length * min_length;
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        float length_sq = x[i] * x[i] + y[i] * y[i];
+        float scale = rsqrt_kernel(length_sq > min_sq ? length_sq : 1.0f);
+        x[i] *= scale;
+        y[i] *= scale;
+    }
+}
+
+static int report(const char *name, double error, double bound) {
+    if (error <= bound) return 0;
+    printf("fast_math: %s error %.3g exceeds %.3g\n", name, error, bound);
+    return 1;
+}
+
+#define CHECK_POINTS 1024
+
+int fast_math_self_check(void) {
+    static float in_a[CHECK_POINTS], in_b[CHECK_POINTS], out_a[CHECK_POINTS], out_b[CHECK_POINTS];
+    double atan2_error = 0.0, sincos_error = 0.0, rsqrt_error = 0.0, batch_error = 0.0;
+
+    // atan2 around the full circle at several radii, including the axes
+    for (int i = 0; i < CHECK_POINTS; i++) {
+        double angle = -CHECK_PI + 2.0 * CHECK_PI * i / (CHECK_POINTS - 1);
+        double radius = 1e-3 * pow(1e6, (double)(i % 7) / 6.0);
+        in_a[i] = (float)(radius * sin(angle));
+        in_b[i] = (float)(radius * cos(angle));
+        double exact = atan2((double)in_a[i], (double)in_b[i]);
+        atan2_error = fmax(atan2_error, fabs(fast_atan2f(in_a[i], in_b[i]) - exact));
+    }
+    fast_atan2_batch(in_a, in_b, out_a, CHECK_POINTS);
+    for (int i = 0; i < CHECK_POINTS; i++) {
+        batch_error = fmax(batch_error, fabs(out_a[i] - fast_atan2f(in_a[i], in_b[i])));
+    }
+
+    // sin/cos over several turns in both directions
+    for (int i = 0; i < CHECK_POINTS; i++) {
+        in_a[i] = (float)(-20.0 + 40.0 * i / (CHECK_POINTS - 1));
+        sincos_error = fmax(sincos_error, fabs(fast_sinf(in_a[i]) - sin((double)in_a[i])));
+        sincos_error = fmax(sincos_error, fabs(fast_cosf(in_a[i]) - cos((double)in_a[i])));
+    }
+    fast_sincos_batch(in_a, out_a, out_b, CHECK_POINTS);
+    for (int i = 0; i < CHECK_POINTS; i++) {
+        batch_error = fmax(batch_error, fabs(out_a[i] - fast_sinf(in_a[i])));
+        batch_error = fmax(batch_error, fabs(out_b[i] - fast_cosf(in_a[i])));
+    }
+
+    // rsqrt across the exponent range
+    for (int i = 0; i < CHECK_POINTS; i++) {
+        float value = (float)pow(10.0, -12.0 + 24.0 * i / (CHECK_POINTS - 1));
+        double exact = 1.0 / sqrt((double)value);
+        rsqrt_error = fmax(rsqrt_error, fabs(fast_rsqrtf(value) - exact) / exact);
+    }
+
+    int failures = 0;
+    failures += report("atan2", atan2_error, ATAN2_BOUND);
+    failures += report("sin/cos", sincos_error, SINCOS_BOUND);
+    failures += report("rsqrt", rsqrt_error, RSQRT_BOUND);
+    failures += report("batch", batch_error, 0.0);
+    return failures;
+}
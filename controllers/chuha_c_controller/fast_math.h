@@ -0,0 +1,44 @@
+/*
+ * ChuhaBot Fast Math
+ * ==================
+ *
+ * Polynomial approximations of the trig and square root functions used on
+ * the control path, with scalar and batch versions. The batch loops are
+ * branch-free so the compiler vectorizes them.
+ *
+ * Maximum errors, checked by fast_math_self_check() over the whole input
+ * range (absolute for angles and trig, relative for rsqrt):
+ *   fast_atan2f   3e-6 rad
+ *   fast_sinf/cosf 5e-7 (any input; accuracy degrades beyond +/-1e4 rad)
+ *   fast_rsqrtf   5e-6 relative
+ *
+ * The controller picks its tier at build time: precision.h maps REAL_ATAN2,
+ * REAL_SIN, REAL_COS and REAL_RSQRT to these functions when MATH_TIER_FAST
+ * is defined (make MATH=fast), and to libm otherwise.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+float fast_atan2f(float y, float x);
+float fast_sinf(float angle);
+float fast_cosf(float angle);
+float fast_rsqrtf(float value);
+
+// angle[i] = atan2(y[i], x[i])
+void fast_atan2_batch(const float *y, const float *x, float *angle, int n);
+
+// s[i] = sin(angle[i]), c[i] = cos(angle[i])
+void fast_sincos_batch(const float *angle, float *s, float *c, int n);
+
+// Scale every (x[i], y[i]) with length above min_length to unit length
+void fast_normalize_batch(float *x, float *y, float min_length, int n);
+
+// Compare every function and batch against libm on a dense grid. Returns
+// the number of functions outside their documented bound.
+int fast_math_self_check(void);
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * ChuhaBot Q16.16 Fixed Point
+ * ===========================
+ *
+ * Signed 16.16 fixed-point arithmetic for targets without an FPU: add,
+ * multiply and divide saturate instead of wrapping, and square root, sine,
+ * cosine and atan2 use integer code and lookup tables only.
+ *
+ * Q16() converts a constant; use it on literals, where the compiler folds
+ * it, never on runtime values. Q32() does the same for 32.32 values held in
+ * int64_t, for quantities too small for 16 fractional bits (variances) and
+ * for wide accumulators.
+ *
+ * Maximum error: sin/cos 3e-5, atan2 4e-5 rad, sqrt 1 LSB (1.5e-5).
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+typedef int32_t q16;
+
+#define Q16_ONE 65536
+#define Q16_MAX INT32_MAX
+#define Q16_MIN INT32_MIN
+#define Q16_PI 205887
+#define Q16_HALF_PI 102944
+#define Q16(x) ((q16)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q32(x) ((int64_t)((x) * 4294967296.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+static inline q16 q16_saturate(int64_t value) {
+    if (value > Q16_MAX) return Q16_MAX;
+    if (value < Q16_MIN) return Q16_MIN;
+    return (q16)value;
+}
+
+static inline q16 q16_add(q16 a, q16 b) {
+    return q16_saturate((int64_t)a + b);
+}
+
+static inline q16 q16_sub(q16 a, q16 b) {
+    return q16_saturate((int64_t)a - b);
+}
+
+static inline q16 q16_mul(q16 a, q16 b) {
+    return q16_saturate(((int64_t)a * b) >> 16);
+}
+
+// Division by zero saturates toward the sign of a
+static inline q16 q16_div(q16 a, q16 b) {
+    if (b == 0) return a >= 0 ? Q16_MAX : Q16_MIN;
+    return q16_saturate(((int64_t)a * Q16_ONE) / b);
+}
+
+// num / den rounded to nearest, for den > 0
+static inline int64_t div_round64(int64_t num, int64_t den) {
+    return (num >= 0 ? num + den / 2 : num - den / 2) / den;
+}
+
+static inline q16 q16_clamp(q16 value, q16 lo, q16 hi) {
+    if (value < lo) return lo;
+    if (value > hi) return hi;
+    return value;
+}
+
+// floor(sqrt(value)) of a 64-bit integer
+uint32_t isqrt64(uint64_t value);
+
+q16 q16_sqrt(q16 value);
+
+// Length of (x, y), without intermediate overflow
+q16 q16_length(q16 x, q16 y);
+
+// Unit vector along (x, y), whose components share any fixed-point scale
+// (Q16.16, Q32.32, products of the two...), when its length at that scale
+// exceeds min_length. The components are renormalized to 30 bits first, so
+// the direction keeps full Q16 precision for short vectors and wide sums
+// alike. Returns 0 and leaves unit_x, unit_y untouched otherwise.
+int q16_unit_vector(int64_t x, int64_t y, int64_t min_length, q16 *unit_x, q16 *unit_y);
+
+q16 q16_sin(q16 angle);
+q16 q16_cos(q16 angle);
+q16 q16_atan2(q16 y, q16 x);
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * ChuhaBot Formation Slots
+ * ========================
+ *
+ * Slot templates and incremental member-to-slot matching.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "formation.h"
+
+#include <math.h>
+#include <string.h>
+
+#define FORMATION_PI 3.14159265358979f
+#define V_HALF_ANGLE 0.6f             // Radians between each arm and the heading
+#define SWAP_MARGIN 0.1f              // Fraction of spacing^2 a swap must save, so near-ties do not flip-flop
+#define MIN_GROUP_SPEED 0.01f         // m/s, below this the group heading is kept
+
+void formation_init(Formation *formation, FormationType type, float spacing) {
+    formation->type = type;
+    formation->spacing = spacing;
+    formation->slot_count = 0;
+    formation->heading = 0.0f;
+    formation->member_count = 0;
+    formation->reassigned = 0;
+}
+
+// Lay out count slots of the formation, then center them on their centroid
+static void build_template(Formation *formation, int count) {
+    float *tx = formation->template_x, *ty = formation->template_y;
+    float spacing = formation->spacing;
+
+    for (int s = 0; s < count; s++) {
+        switch (formation->type) {
+            case FORMATION_CIRCLE: {
+                // Radius that puts neighboring slots spacing apart
+                float radius = count > 1 ? spacing / (2.0f * sinf(FORMATION_PI / count)) : 0.0f;
+                float angle = 2.0f * FORMATION_PI * s / count;
+                tx[s] = radius * cosf(angle);
+                ty[s] = radius * sinf(angle);
+                break;
+            }
+            case FORMATION_LINE:
+                tx[s] = 0.0f;
+                ty[s] = spacing * s;
+                break;
+            case FORMATION_V: {
+                // Apex first, then alternating left and right arm slots
+                int rank = (s + 1) / 2;
+                float side = s % 2 == 1 ? 1.0f : -1.0f;
+                tx[s] = -rank * spacing * cosf(V_HALF_ANGLE);
+                ty[s] = side * rank * spacing * sinf(V_HALF_ANGLE);
+                break;
+            }
+            default:
+                tx[s] = 0.0f;
+                ty[s] = 0.0f;
+                break;
+        }
+    }
+
+    float mean_x = 0.0f, mean_y = 0.0f;
+    for (int s = 0; s < count; s++) {
+        mean_x += tx[s];
+        mean_y += ty[s];
+    }
+    mean_x /= count;
+    mean_y /= count;
+    for (int s = 0; s < count; s++) {
+        tx[s] -= mean_x;
+        ty[s] -= mean_y;
+    }
+    formation->slot_count = count;
+}
+
+// Slot of the current template nearest to (x, y), relative to the centroid
+static int nearest_slot(const Formation *formation, float x, float y) {
+    int best = 0;
+    float best_cost = 0.0f;
+    for (int s = 0; s < formation->slot_count; s++) {
+        float dx = formation->template_x[s] - x, dy = formation->template_y[s] - y;
+        float cost = dx * dx + dy * dy;
+        if (s == 0 || cost < best_cost) {
+            best = s;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+int formation_assign(Formation *formation, const float *x, const float *y,
+                     const float *vx, const float *vy, const int *key, int count,
+                     float *slot_x, float *slot_y) {
+    if (count > FORMATION_MAX_MEMBERS) count = FORMATION_MAX_MEMBERS;
+    if (count < 1) {
+        *slot_x = 0.0f;
+        *slot_y = 0.0f;
+        return -1;
+    }
+
+    // A new template keeps the member map: remembered slots move to the
+    // nearest new slot, and members that collide are matched again below
+    if (count != formation->slot_count) {
+        float old_x[FORMATION_MAX_MEMBERS], old_y[FORMATION_MAX_MEMBERS];
+        memcpy(old_x, formation->template_x, sizeof(old_x));
+        memcpy(old_y, formation->template_y, sizeof(old_y));
+        build_template(formation, count);
+        for (int m = 0; m < formation->member_count; m++) {
+            int old_slot = formation->member_slot[m];
+            formation->member_slot[m] = nearest_slot(formation, old_x[old_slot], old_y[old_slot]);
+        }
+    }
+
+    float center_x = 0.0f, center_y = 0.0f, velocity_x = 0.0f, velocity_y = 0.0f;
+    for (int i = 0; i < count; i++) {
+        center_x += x[i];
+        center_y += y[i];
+        velocity_x += vx[i];
+        velocity_y += vy[i];
+    }
+    center_x /= count;
+    center_y /= count;
+
+    // Turn the template to the group's direction of travel
+    float min_speed = MIN_GROUP_SPEED * count;
+    if (velocity_x * velocity_x + velocity_y * velocity_y > min_speed * min_speed) {
+        formation->heading = atan2f(velocity_y, velocity_x);
+    }
+    float cos_heading = cosf(formation->heading), sin_heading = sinf(formation->heading);
+
+    float goal_x[FORMATION_MAX_MEMBERS], goal_y[FORMATION_MAX_MEMBERS];
+    for (int s = 0; s < count; s++) {
+        float tx = formation->template_x[s], ty = formation->template_y[s];
+        goal_x[s] = center_x + cos_heading * tx - sin_heading * ty;
+        goal_y[s] = center_y + sin_heading * tx + cos_heading * ty;
+    }
+
+    int slot[FORMATION_MAX_MEMBERS], previous[FORMATION_MAX_MEMBERS], owner[FORMATION_MAX_MEMBERS];
+    for (int s = 0; s < count; s++) owner[s] = -1;
+
+    // 1. Known members keep their slot
+    for (int i = 0; i < count; i++) {
+        slot[i] = -1;
+        previous[i] = -1;
+        if (key[i] == 0) continue;
+        for (int m = 0; m < formation->member_count; m++) {
+            if (formation->member_key[m] == key[i]) {
+                previous[i] = formation->member_slot[m];
+                break;
+            }
+        }
+        if (previous[i] >= 0 && owner[previous[i]] < 0) {
+            slot[i] = previous[i];
+            owner[slot[i]] = i;
+        }
+    }
+
+    // 2. Everyone else takes the nearest free slot
+    for (int i = 0; i < count; i++) {
+        if (slot[i] >= 0) continue;
+        int best = -1;
+        float best_cost = 0.0f;
+        for (int s = 0; s < count; s++) {
+            if (owner[s] >= 0) continue;
+            float dx = goal_x[s] - x[i], dy = goal_y[s] - y[i];
+            float cost = dx * dx + dy * dy;
+            if (best < 0 || cost < best_cost) {
+                best = s;
+                best_cost = cost;
+            }
+        }
+        slot[i] = best;
+        owner[best] = i;
+    }
+
+    // 3. One sweep of improving pairwise swaps
+    float margin = SWAP_MARGIN * formation->spacing * formation->spacing;
+    for (int a = 0; a < count; a++) {
+        for (int b = a + 1; b < count; b++) {
+            int sa = slot[a], sb = slot[b];
+            float ax = goal_x[sa] - x[a], ay = goal_y[sa] - y[a];
+            float bx = goal_x[sb] - x[b], by = goal_y[sb] - y[b];
+            float cx = goal_x[sb] - x[a], cy = goal_y[sb] - y[a];
+            float dx = goal_x[sa] - x[b], dy = goal_y[sa] - y[b];
+            float kept = ax * ax + ay * ay + bx * bx + by * by;
+            float swapped = cx * cx + cy * cy + dx * dx + dy * dy;
+            if (swapped < kept - margin) {
+                slot[a] = sb;
+                slot[b] = sa;
+            }
+        }
+    }
+
+    int reassigned = 0;
+    for (int i = 0; i < count; i++) {
+        reassigned += previous[i] >= 0 && slot[i] != previous[i];
+        formation->member_key[i] = key[i];
+        formation->member_slot[i] = slot[i];
+    }
+    formation->member_count = count;
+    formation->reassigned = reassigned;
+
+    *slot_x = goal_x[slot[0]];
+    *slot_y = goal_y[slot[0]];
+    return slot[0];
+}
+
+FormationType formation_type_from_name(const char *name) {
+    if (strcmp(name, "circle") == 0) return FORMATION_CIRCLE;
+    if (strcmp(name, "line") == 0) return FORMATION_LINE;
+    if (strcmp(name, "v") == 0) return FORMATION_V;
+    return FORMATION_NONE;
+}
+
+const char *formation_type_name(FormationType type) {
+    switch (type) {
+        case FORMATION_CIRCLE: return "circle";
+        case FORMATION_LINE: return "line";
+        case FORMATION_V: return "v";
+        default: return "none";
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * ChuhaBot Formation Slots
+ * ========================
+ *
+ * Circle, line and V formations for a robot and the neighbors it sees,
+ * in the robot's own frame (x ahead, y left). Slots are a template centered
+ * on the group centroid, recomputed only when the member count or the shape
+ * changes. Members are matched to slots incrementally:
+ *
+ *   1. members with a stable key keep last step's slot
+ *   2. new or untracked members take the nearest free slot
+ *   3. one sweep of pairwise swaps lowers the total squared distance
+ *
+ * so slots stay put from step to step and the matching converges over a
+ * few steps instead of being solved from scratch each time. When the group
+ * grows or shrinks, each remembered slot moves to the nearest slot of the
+ * new template, so only members left without one are matched again.
+ *
+ * The template is turned to the group's direction of travel, the mean
+ * velocity of all members: the line runs abreast of it and the V's apex
+ * leads, with its arms trailing back. Neighbor velocities have the
+ * observer's own motion removed, so every robot of the group finds the
+ * same direction in its own frame and they agree on the shape. While the
+ * group is nearly still the last direction is kept.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef FORMATION_H
+#define FORMATION_H
+
+#ifndef FORMATION_MAX_MEMBERS
+#define FORMATION_MAX_MEMBERS 64
+#endif
+
+typedef enum {
+    FORMATION_NONE,
+    FORMATION_CIRCLE,
+    FORMATION_LINE,
+    FORMATION_V
+} FormationType;
+
+typedef struct {
+    FormationType type;
+    float spacing;                            // Meters between neighboring slots
+    int slot_count;                           // Members the template was built for
+    float heading;                            // Group direction of travel, radians in this robot's frame
+    float template_x[FORMATION_MAX_MEMBERS];  // Slots relative to the group centroid
+    float template_y[FORMATION_MAX_MEMBERS];
+    int member_count;                         // Members of the last step
+    int member_key[FORMATION_MAX_MEMBERS];
+    int member_slot[FORMATION_MAX_MEMBERS];
+    int reassigned;                           // Known members that changed slot last step
+} Formation;
+
+void formation_init(Formation *formation, FormationType type, float spacing);
+
+// Match count members (at most FORMATION_MAX_MEMBERS) to slots. Positions
+// and velocities are in this robot's frame, and this robot must be member
+// 0. Velocities are 0 where unknown. key is a stable identity per member,
+// 0 if it has none (untracked neighbors). Writes the position of member 0's
+// slot and returns its index.
+int formation_assign(Formation *formation, const float *x, const float *y,
+                     const float *vx, const float *vy, const int *key, int count,
+                     float *slot_x, float *slot_y);
+
+// "circle", "line" or "v"; FORMATION_NONE for anything else
+FormationType formation_type_from_name(const char *name);
+const char *formation_type_name(FormationType type);
+
+#endif
@@ -0,0 +1,249 @@
+/*
+ * ChuhaBot Software Framebuffer
+ * =============================
+ *
+ * Clipped RGBA rasterization, changed-row detection and a stored-block PNG
+ * writer.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "framebuffer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEFLATE_BLOCK_MAX 65535    // Largest stored (uncompressed) deflate block
+
+void framebuffer_init(Framebuffer *fb, uint8_t *pixels, int width, int height) {
+    fb->width = width;
+    fb->height = height;
+    fb->rgba = pixels;
+}
+
+static inline void put_pixel(Framebuffer *fb, int x, int y, int color) {
+    uint8_t *p = fb->rgba + ((size_t)y * fb->width + x) * 4;
+    p[0] = (uint8_t)(color >> 16);
+    p[1] = (uint8_t)(color >> 8);
+    p[2] = (uint8_t)color;
+    p[3] = 0xFF;
+}
+
+// Pixels x0 .. x1 - 1 of row y, already clipped
+static void fill_span(Framebuffer *fb, int y, int x0, int x1, int color) {
+    for (int x = x0; x < x1; x++) put_pixel(fb, x, y, color);
+}
+
+void framebuffer_clear(Framebuffer *fb, int color) {
+    framebuffer_fill_rectangle(fb, 0, 0, fb->width, fb->height, color);
+}
+
+void framebuffer_fill_rectangle(Framebuffer *fb, int x, int y, int width, int height, int color) {
+    int x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+    int x1 = x + width > fb->width ? fb->width : x + width;
+    int y1 = y + height > fb->height ? fb->height : y + height;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    // Rasterize the first row, then copy it down
+    fill_span(fb, y0, x0, x1, color);
+    size_t row_bytes = (size_t)fb->width * 4;
+    const uint8_t *first = fb->rgba + y0 * row_bytes + (size_t)x0 * 4;
+    for (int row = y0 + 1; row < y1; row++) {
+        memcpy(fb->rgba + row * row_bytes + (size_t)x0 * 4, first, (size_t)(x1 - x0) * 4);
+    }
+}
+
+void framebuffer_fill_oval(Framebuffer *fb, int cx, int cy, int rx, int ry, int color) {
+    if (rx < 0 || ry < 0) return;
+    long long rx2 = (long long)rx * rx, ry2 = (long long)ry * ry;
+
+    for (int dy = -ry; dy <= ry; dy++) {
+        int y = cy + dy;
+        if (y < 0 || y >= fb->height) continue;
+
+        // Widest dx with (dx / rx)^2 + (dy / ry)^2 <= 1, in integers
+        int half = rx;
+        if (ry > 0) {
+            long long limit = rx2 * (ry2 - (long long)dy * dy);
+            half = (int)sqrt((double)limit / (double)ry2);
+            while ((long long)(half + 1) * (half + 1) * ry2 <= limit) half++;
+            while (half > 0 && (long long)half * half * ry2 > limit) half--;
+        }
+
+        int x0 = cx - half < 0 ? 0 : cx - half;
+        int x1 = cx + half + 1 > fb->width ? fb->width : cx + half + 1;
+        if (x0 < x1) fill_span(fb, y, x0, x1, color);
+    }
+}
+
+void framebuffer_draw_line(Framebuffer *fb, int x0, int y0, int x1, int y1, int color) {
+    int dx = x1 > x0 ? x1 - x0 : x0 - x1, sx = x0 < x1 ? 1 : -1;
+    int dy = y1 > y0 ? y0 - y1 : y1 - y0, sy = y0 < y1 ? 1 : -1;
+    int error = dx + dy;
+
+    for (;;) {
+        if (x0 >= 0 && x0 < fb->width && y0 >= 0 && y0 < fb->height) put_pixel(fb, x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * error;
+        if (e2 >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+int framebuffer_diff_rows(const Framebuffer *fb, uint8_t *shadow, int *first_row) {
+    size_t row_bytes = (size_t)fb->width * 4;
+    int first = 0, last = fb->height - 1;
+
+    while (first <= last && memcmp(fb->rgba + first * row_bytes, shadow + first * row_bytes, row_bytes) == 0) first++;
+    if (first > last) {
+        *first_row = 0;
+        return 0;
+    }
+    while (memcmp(fb->rgba + last * row_bytes, shadow + last * row_bytes, row_bytes) == 0) last--;
+
+    memcpy(shadow + first * row_bytes, fb->rgba + first * row_bytes, (size_t)(last - first + 1) * row_bytes);
+    *first_row = first;
+    return last - first + 1;
+}
+
+// PNG output. The image data is a zlib stream of stored deflate blocks, so
+// no compressor is needed; each block is DEFLATE_BLOCK_MAX bytes except the
+// last, which lets the chunk length be known before writing.
+typedef struct {
+    FILE *file;
+    uint32_t crc;                  // Running CRC of the current chunk
+    uint32_t adler_a, adler_b;     // Running Adler-32 of the image data
+    size_t block_fill;
+    int failed;
+} PngWriter;
+
+static uint32_t crc_table[256];
+static int crc_table_ready = 0;
+static uint8_t deflate_block[DEFLATE_BLOCK_MAX];
+
+static void build_crc_table(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crc_table[n] = c;
+    }
+    crc_table_ready = 1;
+}
+
+// Write bytes that belong to the current chunk
+static void png_put(PngWriter *w, const uint8_t *data, size_t count) {
+    for (size_t i = 0; i < count; i++) w->crc = crc_table[(w->crc ^ data[i]) & 0xFF] ^ (w->crc >> 8);
+    if (fwrite(data, 1, count, w->file) != count) w->failed = 1;
+}
+
+static void png_put_u32(PngWriter *w, uint32_t value) {
+    uint8_t bytes[4] = {(uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
+    png_put(w, bytes, 4);
+}
+
+static void png_begin_chunk(PngWriter *w, const char *type, uint32_t length) {
+    uint8_t bytes[4] = {(uint8_t)(length >> 24), (uint8_t)(length >> 16), (uint8_t)(length >> 8), (uint8_t)length};
+    if (fwrite(bytes, 1, 4, w->file) != 4) w->failed = 1;
+    w->crc = 0xFFFFFFFFu;
+    png_put(w, (const uint8_t *)type, 4);
+}
+
+static void png_end_chunk(PngWriter *w) {
+    uint8_t bytes[4];
+    uint32_t crc = w->crc ^ 0xFFFFFFFFu;
+    bytes[0] = (uint8_t)(crc >> 24);
+    bytes[1] = (uint8_t)(crc >> 16);
+    bytes[2] = (uint8_t)(crc >> 8);
+    bytes[3] = (uint8_t)crc;
+    if (fwrite(bytes, 1, 4, w->file) != 4) w->failed = 1;
+}
+
+static void flush_block(PngWriter *w, int final) {
+    uint16_t length = (uint16_t)w->block_fill;
+    uint8_t header[5] = {(uint8_t)final, (uint8_t)length, (uint8_t)(length >> 8),
+                         (uint8_t)~length, (uint8_t)(~length >> 8)};
+    png_put(w, header, 5);
+    png_put(w, deflate_block, w->block_fill);
+    w->block_fill = 0;
+}
+
+// Adler-32 with the modulo deferred: 5552 bytes is the most that cannot
+// overflow the 32-bit sums
+static void adler_update(PngWriter *w, const uint8_t *data, size_t count) {
+    while (count > 0) {
+        size_t n = count < 5552 ? count : 5552;
+        for (size_t i = 0; i < n; i++) {
+            w->adler_a += data[i];
+            w->adler_b += w->adler_a;
+        }
+        w->adler_a %= 65521u;
+        w->adler_b %= 65521u;
+        data += n;
+        count -= n;
+    }
+}
+
+// Append image data, emitting a non-final block whenever one fills up
+static void png_put_data(PngWriter *w, const uint8_t *data, size_t count) {
+    adler_update(w, data, count);
+    while (count > 0) {
+        if (w->block_fill == DEFLATE_BLOCK_MAX) flush_block(w, 0);
+        size_t n = DEFLATE_BLOCK_MAX - w->block_fill;
+        n = n < count ? n : count;
+        memcpy(deflate_block + w->block_fill, data, n);
+        w->block_fill += n;
+        data += n;
+        count -= n;
+    }
+}
+
+int framebuffer_write_png(const Framebuffer *fb, const char *path) {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (!crc_table_ready) build_crc_table();
+
+    PngWriter w;
+    w.file = fopen(path, "wb");
+    if (!w.file) return -1;
+    w.failed = fwrite(signature, 1, 8, w.file) != 8;
+    w.adler_a = 1;
+    w.adler_b = 0;
+    w.block_fill = 0;
+
+    // 8-bit RGBA, no interlacing
+    png_begin_chunk(&w, "IHDR", 13);
+    png_put_u32(&w, (uint32_t)fb->width);
+    png_put_u32(&w, (uint32_t)fb->height);
+    const uint8_t format[5] = {8, 6, 0, 0, 0};
+    png_put(&w, format, 5);
+    png_end_chunk(&w);
+
+    // Each row is a filter type byte (0, none) and the pixels
+    size_t row_bytes = (size_t)fb->width * 4;
+    size_t raw_bytes = (size_t)fb->height * (row_bytes + 1);
+    size_t blocks = (raw_bytes + DEFLATE_BLOCK_MAX - 1) / DEFLATE_BLOCK_MAX;
+    png_begin_chunk(&w, "IDAT", (uint32_t)(2 + 5 * blocks + raw_bytes + 4));
+    const uint8_t zlib_header[2] = {0x78, 0x01};
+    png_put(&w, zlib_header, 2);
+    const uint8_t filter = 0;
+    for (int y = 0; y < fb->height; y++) {
+        png_put_data(&w, &filter, 1);
+        png_put_data(&w, fb->rgba + y * row_bytes, row_bytes);
+    }
+    flush_block(&w, 1);
+    png_put_u32(&w, (w.adler_b << 16) | w.adler_a);
+    png_end_chunk(&w);
+
+    png_begin_chunk(&w, "IEND", 0);
+    png_end_chunk(&w);
+
+    if (fclose(w.file) != 0) w.failed = 1;
+    return w.failed ? -1 : 0;
+}
@@ -0,0 +1,49 @@
+/*
+ * ChuhaBot Software Framebuffer
+ * =============================
+ *
+ * An RGBA8 image in memory (bytes R, G, B, A per pixel, rows top to bottom)
+ * with the few primitives the controller overlay needs. The semantics match
+ * the Webots display calls they replace: fill_oval takes the center and
+ * radii, fill_rectangle the corner and size, and lines include both end
+ * points. Everything is clipped to the image. Colors are 0xRRGGBB, as for
+ * wb_display_set_color(), and always opaque.
+ *
+ * The buffer is the pixel format of WB_IMAGE_RGBA, so a whole frame goes
+ * to the display as one image. framebuffer_diff_rows() finds the band of
+ * rows that changed since the last frame sent, so only that band needs to
+ * be transferred. framebuffer_write_png() saves a frame without the
+ * display (and without zlib) for headless runs.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <stdint.h>
+
+typedef struct {
+    int width, height;
+    uint8_t *rgba;                 // width * height * 4 bytes, owned by the caller
+} Framebuffer;
+
+// Attach caller storage of width * height * 4 bytes
+void framebuffer_init(Framebuffer *fb, uint8_t *pixels, int width, int height);
+
+void framebuffer_clear(Framebuffer *fb, int color);
+void framebuffer_fill_rectangle(Framebuffer *fb, int x, int y, int width, int height, int color);
+void framebuffer_fill_oval(Framebuffer *fb, int cx, int cy, int rx, int ry, int color);
+void framebuffer_draw_line(Framebuffer *fb, int x0, int y0, int x1, int y1, int color);
+
+// Compare the frame with shadow (a copy of the last frame sent, same size)
+// and copy the changed rows into it. Returns the number of rows in the band
+// first_row .. first_row + n - 1 that contains every change, 0 if none.
+int framebuffer_diff_rows(const Framebuffer *fb, uint8_t *shadow, int *first_row);
+
+// Write the frame as an uncompressed RGBA PNG. Returns 0, or -1 if the file
+// cannot be written.
+int framebuffer_write_png(const Framebuffer *fb, const char *path);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * ChuhaBot Fast Math Benchmark
+ * ============================
+ *
+ * Host timing of fast_math.c (make bench): atan2, sin + cos and vector
+ * normalization over the headings and forces of BENCH_ROBOTS robots, per
+ * robot with libm, with the scalar fast functions and with the batch
+ * functions. These are the numbers of the fast math table in the README.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+// clock_gettime() is POSIX, not C99
+#define _POSIX_C_SOURCE 199309L
+
+#include "../fast_math.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_ROBOTS 1000
+#define BENCH_REPEATS 2000
+#define BENCH_PI 3.14159265359f
+
+static float x[BENCH_ROBOTS], y[BENCH_ROBOTS], angle[BENCH_ROBOTS];
+static float out_a[BENCH_ROBOTS], out_b[BENCH_ROBOTS];
+static float norm_x[BENCH_ROBOTS], norm_y[BENCH_ROBOTS];
+static volatile float sink;             // Keeps the results alive
+
+static double now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static float bench_random(unsigned int *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (*state >> 8) * (1.0f / 16777216.0f);
+}
+
+// Forces of a few units in any direction, and headings over several turns
+static void fill_inputs(void) {
+    unsigned int state = 2024u;
+    for (int i = 0; i < BENCH_ROBOTS; i++) {
+        x[i] = (bench_random(&state) - 0.5f) * 8.0f;
+        y[i] = (bench_random(&state) - 0.5f) * 8.0f;
+        angle[i] = (bench_random(&state) - 0.5f) * 8.0f * BENCH_PI;
+    }
+}
+
+static void reset_forces(void) {
+    for (int i = 0; i < BENCH_ROBOTS; i++) {
+        norm_x[i] = x[i];
+        norm_y[i] = y[i];
+    }
+}
+
+static float checksum(const float *a, const float *b) {
+    float sum = 0.0f;
+    for (int i = 0; i < BENCH_ROBOTS; i++) sum += a[i] + b[i];
+    return sum;
+}
+
+static void print_row(const char *name, double libm, double scalar, double batch) {
+    double per_robot = 1.0 / ((double)BENCH_REPEATS * BENCH_ROBOTS);
+    printf("  %-10s %8.2f %8.2f %8.2f\n", name, libm * per_robot, scalar * per_robot, batch * per_robot);
+}
+
+static void bench_atan2(void) {
+    double start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        for (int i = 0; i < BENCH_ROBOTS; i++) out_a[i] = atan2f(y[i], x[i]);
+        sink = out_a[r % BENCH_ROBOTS];
+    }
+    double libm = now_ns() - start;
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        for (int i = 0; i < BENCH_ROBOTS; i++) out_a[i] = fast_atan2f(y[i], x[i]);
+        sink = out_a[r % BENCH_ROBOTS];
+    }
+    double scalar = now_ns() - start;
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        fast_atan2_batch(y, x, out_a, BENCH_ROBOTS);
+        sink = out_a[r % BENCH_ROBOTS];
+    }
+    print_row("atan2", libm, scalar, now_ns() - start);
+}
+
+static void bench_sincos(void) {
+    double start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        for (int i = 0; i < BENCH_ROBOTS; i++) {
+            out_a[i] = sinf(angle[i]);
+            out_b[i] = cosf(angle[i]);
+        }
+        sink = out_a[r % BENCH_ROBOTS] + out_b[r % BENCH_ROBOTS];
+    }
+    double libm = now_ns() - start;
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        for (int i = 0; i < BENCH_ROBOTS; i++) {
+            out_a[i] = fast_sinf(angle[i]);
+            out_b[i] = fast_cosf(angle[i]);
+        }
+        sink = out_a[r % BENCH_ROBOTS] + out_b[r % BENCH_ROBOTS];
+    }
+    double scalar = now_ns() - start;
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        fast_sincos_batch(angle, out_a, out_b, BENCH_ROBOTS);
+        sink = out_a[r % BENCH_ROBOTS] + out_b[r % BENCH_ROBOTS];
+    }
+    print_row("sin + cos", libm, scalar, now_ns() - start);
+}
+
+// Each repeat normalizes fresh copies of the forces. The time to copy and
+// sum them alone is subtracted from all three columns.
+static void bench_normalize(void) {
+    double start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        reset_forces();
+        sink = checksum(norm_x, norm_y);
+    }
+    double copy = now_ns() - start;
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        reset_forces();
+        for (int i = 0; i < BENCH_ROBOTS; i++) {
+            float length = sqrtf(norm_x[i] * norm_x[i] + norm_y[i] * norm_y[i]);
+            if (length > 1e-3f) {
+                norm_x[i] /= length;
+                norm_y[i] /= length;
+            }
+        }
+        sink = checksum(norm_x, norm_y);
+    }
+    double libm = now_ns() - start - copy;
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        reset_forces();
+        for (int i = 0; i < BENCH_ROBOTS; i++) {
+            float length_sq = norm_x[i] * norm_x[i] + norm_y[i] * norm_y[i];
+            if (length_sq > 1e-6f) {
+                float scale = fast_rsqrtf(length_sq);
+                norm_x[i] *= scale;
+                norm_y[i] *= scale;
+            }
+        }
+        sink = checksum(norm_x, norm_y);
+    }
+    double scalar = now_ns() - start - copy;
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        reset_forces();
+        fast_normalize_batch(norm_x, norm_y, 1e-3f, BENCH_ROBOTS);
+        sink = checksum(norm_x, norm_y);
+    }
+    print_row("normalize", libm, scalar, now_ns() - start - copy);
+}
+
+int main(void) {
+    fill_inputs();
+    printf("Per robot (ns), %d robots\n", BENCH_ROBOTS);
+    printf("  %-10s %8s %8s %8s\n", "function", "libm", "scalar", "batch");
+    bench_atan2();
+    bench_sincos();
+    bench_normalize();
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * ChuhaBot Motor Log Comparison
+ * =============================
+ *
+ * Compares two REPLAY_MOTOR_LOG files step by step (make compare):
+ *
+ *   motor_diff REFERENCE CANDIDATE [TOLERANCE]
+ *
+ * Prints the largest, mean and 99.9th percentile wheel velocity deviation
+ * in rad/s over both wheels, and exits with 1 when the logs differ in
+ * length or the largest deviation exceeds TOLERANCE (default: report only).
+ *
+ * Also counts turn flips: steps where both builds turn hard, in opposite
+ * directions. The controller turns at full speed toward a force pointing
+ * straight back, and which way depends on the side of the atan2 branch cut
+ * at +-pi the force lands on, so a rounding difference can flip it.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define FLIP_DIFFERENTIAL 60.0          // rad/s between the wheels, a hard turn
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s REFERENCE CANDIDATE [TOLERANCE]\n", argv[0]);
+        return 2;
+    }
+    FILE *reference = fopen(argv[1], "r");
+    FILE *candidate = fopen(argv[2], "r");
+    if (!reference || !candidate) {
+        fprintf(stderr, "motor_diff: cannot read %s\n", reference ? argv[2] : argv[1]);
+        return 2;
+    }
+
+    size_t count = 0, capacity = 4096;
+    double *deviation = malloc(capacity * sizeof(double));
+    double sum = 0.0, ref_left, ref_right, left, right;
+    int mismatch = 0, flips = 0;
+    for (;;) {
+        int ref_ok = fscanf(reference, "%lf %lf", &ref_left, &ref_right) == 2;
+        int ok = fscanf(candidate, "%lf %lf", &left, &right) == 2;
+        if (ref_ok != ok) mismatch = 1;
+        if (!ref_ok || !ok) break;
+
+        if (count + 2 > capacity) {
+            capacity *= 2;
+            deviation = realloc(deviation, capacity * sizeof(double));
+        }
+        double ref_turn = ref_right - ref_left, turn = right - left;
+        if (ref_turn * turn < 0.0 && fabs(ref_turn) > FLIP_DIFFERENTIAL && fabs(turn) > FLIP_DIFFERENTIAL) {
+            flips++;
+        }
+        deviation[count++] = fabs(left - ref_left);
+        deviation[count++] = fabs(right - ref_right);
+        sum += deviation[count - 2] + deviation[count - 1];
+    }
+    fclose(reference);
+    fclose(candidate);
+
+    if (count == 0) {
+        fprintf(stderr, "motor_diff: no motor commands to compare\n");
+        free(deviation);
+        return 2;
+    }
+    qsort(deviation, count, sizeof(double), compare_doubles);
+    double max = deviation[count - 1];
+    double p999 = deviation[(size_t)(0.999 * (count - 1))];
+    printf("%zu steps, wheel velocity deviation (rad/s): max %.6g  mean %.6g  p99.9 %.6g  turn flips %d\n",
+           count / 2, max, sum / count, p999, flips);
+    free(deviation);
+
+    if (mismatch) {
+        printf("FAIL: logs have different lengths\n");
+        return 1;
+    }
+    if (argc > 3 && max > atof(argv[3])) {
+        printf("FAIL: max deviation above tolerance %s rad/s\n", argv[3]);
+        return 1;
+    }
+    return 0;
+}
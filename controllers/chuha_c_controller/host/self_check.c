@@ -0,0 +1,35 @@
+/*
+ * ChuhaBot Host Self-Checks
+ * =========================
+ *
+ * Runs the self-checks of the controller modules on the host (make test):
+ * every scan kernel variant this CPU supports against the scalar
+ * reference, the fast math functions and batches against libm, and the
+ * step profile histograms. Prints each failure and
+ * exits with 1 if any check fails.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "../fast_math.h"
+#include "../scan_kernels.h"
+#include "../step_profile.h"
+
+#include <stdio.h>
+
+static int report(const char *name, int failures) {
+    printf("%-14s %s\n", name, failures == 0 ? "ok" : "FAILED");
+    return failures != 0;
+}
+
+int main(void) {
+    int failed = 0;
+
+    scan_kernels_init();
+    printf("Scan kernels: scalar up to %s\n", scan_kernels.name);
+    failed += report("scan_kernels", scan_kernels_self_check(1e-4f));
+    failed += report("fast_math", fast_math_self_check());
+    failed += report("step_profile", step_profile_self_check());
+    return failed != 0;
+}
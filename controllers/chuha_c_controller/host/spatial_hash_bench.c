@@ -0,0 +1,102 @@
+/*
+ * ChuhaBot Spatial Hash Benchmark
+ * ===============================
+ *
+ * Host check of spatial_hash.c (make bench): runs its brute-force
+ * self-check, then times one update and one query per robot against
+ * comparing every pair, for swarms drifting at a 0.5 m interaction radius
+ * and ~2.5 robots per m². Exits with 1 if the self-check fails.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+// clock_gettime() is POSIX, not C99
+#define _POSIX_C_SOURCE 199309L
+
+#include "../spatial_hash.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_RADIUS 0.5f
+#define BENCH_DENSITY 2.5f              // Robots per m²
+#define BENCH_STEPS 200
+#define BENCH_DRIFT 0.02f               // Meters per step, at most
+
+static SpatialHash hash;
+static float x[SPATIAL_HASH_MAX_ROBOTS], y[SPATIAL_HASH_MAX_ROBOTS];
+static volatile int sink;               // Keeps the neighbor counts alive
+
+static double now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+static float bench_random(unsigned int *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (*state >> 8) * (1.0f / 16777216.0f);
+}
+
+static void bench(int robots) {
+    float side = sqrtf(robots / BENCH_DENSITY);
+    unsigned int state = 2024u;
+    for (int i = 0; i < robots; i++) {
+        x[i] = bench_random(&state) * side;
+        y[i] = bench_random(&state) * side;
+    }
+    spatial_hash_init(&hash, 0.0f, 0.0f, side, side, BENCH_RADIUS);
+    spatial_hash_update(&hash, x, y, robots);
+
+    double update = 0.0, queries = 0.0, pairs = 0.0;
+    for (int step = 0; step < BENCH_STEPS; step++) {
+        for (int i = 0; i < robots; i++) {
+            x[i] = fminf(fmaxf(x[i] + (bench_random(&state) - 0.5f) * 2.0f * BENCH_DRIFT, 0.0f), side);
+            y[i] = fminf(fmaxf(y[i] + (bench_random(&state) - 0.5f) * 2.0f * BENCH_DRIFT, 0.0f), side);
+        }
+
+        double start = now_us();
+        spatial_hash_update(&hash, x, y, robots);
+        double updated = now_us();
+        int found = 0;
+        for (int i = 0; i < robots; i++) {
+            SpatialSpan spans[3];
+            int span_count = spatial_hash_query(&hash, x[i], y[i], spans);
+            for (int s = 0; s < span_count; s++) {
+                for (int k = spans[s].begin; k < spans[s].end; k++) {
+                    float dx = hash.x[k] - x[i], dy = hash.y[k] - y[i];
+                    found += dx * dx + dy * dy <= BENCH_RADIUS * BENCH_RADIUS;
+                }
+            }
+        }
+        double queried = now_us();
+        int brute = 0;
+        for (int i = 0; i < robots; i++) {
+            for (int j = 0; j < robots; j++) {
+                float dx = x[j] - x[i], dy = y[j] - y[i];
+                brute += dx * dx + dy * dy <= BENCH_RADIUS * BENCH_RADIUS;
+            }
+        }
+        double compared = now_us();
+
+        update += updated - start;
+        queries += queried - updated;
+        pairs += compared - queried;
+        sink = found + brute;
+    }
+    printf("  %-8d %8.1f %12.1f %10.1f\n", robots,
+           update / BENCH_STEPS, queries / BENCH_STEPS, pairs / BENCH_STEPS);
+}
+
+int main(void) {
+    if (spatial_hash_self_check() != 0) return 1;
+    printf("Spatial hash self-check passed\n");
+    printf("Per step (us), %.1f m radius, %.1f robots/m²\n", BENCH_RADIUS, BENCH_DENSITY);
+    printf("  %-8s %8s %12s %10s\n", "robots", "update", "all queries", "all pairs");
+    bench(250);
+    bench(1000);
+    bench(2000);
+    return 0;
+}
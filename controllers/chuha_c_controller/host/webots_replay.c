@@ -0,0 +1,219 @@
+/*
+ * ChuhaBot Host Replay
+ * ====================
+ *
+ * Stand-in for the Webots controller library, so the controller runs on a
+ * Linux host without the simulator for benchmarks and build comparisons
+ * (make bench, make compare). Only the robot, motor and LIDAR calls of the
+ * headless build are provided; the declarations come from the real Webots
+ * headers.
+ *
+ * The LIDAR plays back a scan recording (--record-scans, scan_recording.h)
+ * at its recorded period and time step, stopping at its end. Without one
+ * it sees a synthetic arena: 16 layers of 512 beams with no floor return,
+ * and REPLAY_ROBOTS robots spread evenly around the sensor, alternating
+ * between two ranges so each one forms its own cluster. The ring turns
+ * slowly and breathes in and out, so neighbors move and tracks get
+ * velocities. Either way the scans do not depend on the motor commands,
+ * so every build sees exactly the same input.
+ *
+ * Environment:
+ *   REPLAY_STEPS      control steps to run (default 2000)
+ *   REPLAY_SCANS      scan recording to play back instead of the arena
+ *   REPLAY_ROBOTS     robots in the synthetic arena (default 3)
+ *   REPLAY_MOTOR_LOG  file receiving "left right" per control step
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include <webots/robot.h>
+#include <webots/motor.h>
+#include <webots/lidar.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../scan_recording.h"
+
+#define REPLAY_LAYERS 16                // Synthetic arena LIDAR
+#define REPLAY_RESOLUTION 512
+#define REPLAY_TIMESTEP 8               // ms, basicTimeStep of the swarm worlds
+#define REPLAY_MAX_FRAME (16 * 4096)    // Largest recorded frame, in floats
+#define REPLAY_ROBOT_RADIUS 0.03        // m
+#define REPLAY_VISIBLE_LAYERS 4         // Upper layers that see robots at neighbor range
+#define PI 3.14159265359
+
+enum { DEVICE_NONE, DEVICE_LEFT_MOTOR, DEVICE_RIGHT_MOTOR, DEVICE_LIDAR };
+
+static float range_image[REPLAY_MAX_FRAME];
+static int step_count = 0, max_steps = 2000, robot_count = 3;
+static int lidar_period = 0;
+static int time_step = REPLAY_TIMESTEP;
+static ScanRecording recording;         // Open when playing back REPLAY_SCANS
+static BaselineKey lidar = {REPLAY_LAYERS, REPLAY_RESOLUTION, (float)(2.0 * PI), 0.3f, 6.0f};
+static int enable_step = 0;              // Step count when the LIDAR was enabled
+static long scan_frame = 0;             // Frames delivered since, 0 = none yet
+static double left_velocity = 0.0, right_velocity = 0.0;
+static FILE *motor_log = NULL;
+
+static int env_int(const char *name, int fallback) {
+    const char *value = getenv(name);
+    return value && value[0] ? atoi(value) : fallback;
+}
+
+// Render the arena at simulation time t into range_image
+static void synthesize_scan(double t) {
+    for (int i = 0; i < REPLAY_LAYERS * REPLAY_RESOLUTION; i++) range_image[i] = INFINITY;
+
+    double slot = 2.0 * PI / robot_count;
+    for (int k = 0; k < robot_count; k++) {
+        double range = (k & 1 ? 0.6 : 0.4) + 0.02 * sin(0.7 * t + k);
+        double bearing = -PI + (k + 0.5) * slot + 0.05 * t;
+        double half_width = asin(REPLAY_ROBOT_RADIUS / range);
+        if (half_width > 0.35 * slot) half_width = 0.35 * slot;
+
+        int first = (int)floor((bearing - half_width + PI) / (2.0 * PI) * REPLAY_RESOLUTION);
+        int last = (int)ceil((bearing + half_width + PI) / (2.0 * PI) * REPLAY_RESOLUTION);
+        for (int beam = first; beam <= last; beam++) {
+            int i = ((beam % REPLAY_RESOLUTION) + REPLAY_RESOLUTION) % REPLAY_RESOLUTION;
+            double offset = remainder(-PI + 2.0 * PI * i / REPLAY_RESOLUTION - bearing, 2.0 * PI);
+            if (fabs(offset) > half_width) continue;
+            float hit = (float)(range + REPLAY_ROBOT_RADIUS * (1.0 - cos(offset / half_width * PI / 2.0)));
+            for (int layer = 0; layer < REPLAY_VISIBLE_LAYERS; layer++) {
+                range_image[layer * REPLAY_RESOLUTION + i] = hit;
+            }
+        }
+    }
+}
+
+// Next recorded frame, or the synthetic arena at time t. Returns 0 when
+// the recording has ended.
+static int next_scan(double t) {
+    if (!recording.file) {
+        synthesize_scan(t);
+        return 1;
+    }
+    return scan_recording_read(&recording, range_image);
+}
+
+int wb_robot_init(void) {
+    max_steps = env_int("REPLAY_STEPS", max_steps);
+    robot_count = env_int("REPLAY_ROBOTS", robot_count);
+    if (robot_count < 0) robot_count = 0;
+
+    const char *scans = getenv("REPLAY_SCANS");
+    if (scans && scans[0]) {
+        if (!scan_recording_open(&recording, scans) || recording.frame_floats > REPLAY_MAX_FRAME) {
+            fprintf(stderr, "replay: %s is not a usable scan recording\n", scans);
+            exit(1);
+        }
+        lidar = recording.header.lidar;
+        time_step = recording.header.basic_time_step;
+    }
+    const char *log_path = getenv("REPLAY_MOTOR_LOG");
+    if (log_path && log_path[0]) {
+        motor_log = fopen(log_path, "w");
+        if (!motor_log) fprintf(stderr, "replay: cannot write %s\n", log_path);
+    }
+    return 1;
+}
+
+int wb_robot_step(int duration) {
+    (void)duration;
+    if (motor_log && step_count > 0) fprintf(motor_log, "%.9g %.9g\n", left_velocity, right_velocity);
+    if (step_count >= max_steps) return -1;
+    step_count++;
+
+    // A new frame every sampling period after the LIDAR was enabled, taken at
+    // its own timestamp
+    if (lidar_period > 0) {
+        long frame = (long)(step_count - enable_step) * time_step / lidar_period;
+        if (frame != scan_frame) {
+            scan_frame = frame;
+            if (!next_scan((enable_step * time_step + frame * lidar_period) / 1000.0)) return -1;
+        }
+    }
+    return 0;
+}
+
+void wb_robot_cleanup(void) {
+    if (motor_log) fclose(motor_log);
+    motor_log = NULL;
+    scan_recording_close(&recording);
+}
+
+double wb_robot_get_basic_time_step(void) {
+    return time_step;
+}
+
+double wb_robot_get_time(void) {
+    return step_count * time_step / 1000.0;
+}
+
+const char *wb_robot_get_name(void) {
+    return "ChuhaReplay";
+}
+
+WbDeviceTag wb_robot_get_device(const char *name) {
+    if (strcmp(name, "left motor") == 0) return DEVICE_LEFT_MOTOR;
+    if (strcmp(name, "right motor") == 0) return DEVICE_RIGHT_MOTOR;
+    if (strcmp(name, "lidar") == 0) return DEVICE_LIDAR;
+    return DEVICE_NONE;
+}
+
+void wb_motor_set_position(WbDeviceTag tag, double position) {
+    (void)tag;
+    (void)position;
+}
+
+void wb_motor_set_velocity(WbDeviceTag tag, double velocity) {
+    if (tag == DEVICE_LEFT_MOTOR) left_velocity = velocity;
+    if (tag == DEVICE_RIGHT_MOTOR) right_velocity = velocity;
+}
+
+// A recording always plays back at the period it was recorded with. As in
+// Webots, the first frame arrives one sampling period after enabling.
+void wb_lidar_enable(WbDeviceTag tag, int sampling_period) {
+    (void)tag;
+    lidar_period = recording.file ? recording.header.sampling_period : sampling_period;
+    enable_step = step_count;
+    scan_frame = 0;
+}
+
+int wb_lidar_get_sampling_period(WbDeviceTag tag) {
+    (void)tag;
+    return lidar_period;
+}
+
+const float *wb_lidar_get_range_image(WbDeviceTag tag) {
+    (void)tag;
+    return lidar_period > 0 && scan_frame > 0 ? range_image : NULL;
+}
+
+int wb_lidar_get_horizontal_resolution(WbDeviceTag tag) {
+    (void)tag;
+    return lidar.resolution;
+}
+
+int wb_lidar_get_number_of_layers(WbDeviceTag tag) {
+    (void)tag;
+    return lidar.layers;
+}
+
+double wb_lidar_get_fov(WbDeviceTag tag) {
+    (void)tag;
+    return lidar.fov;
+}
+
+double wb_lidar_get_vertical_fov(WbDeviceTag tag) {
+    (void)tag;
+    return lidar.vertical_fov;
+}
+
+double wb_lidar_get_max_range(WbDeviceTag tag) {
+    (void)tag;
+    return lidar.max_range;
+}
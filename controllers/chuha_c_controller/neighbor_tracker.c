@@ -0,0 +1,139 @@
+/*
+ * ChuhaBot Neighbor Tracker
+ * =========================
+ *
+ * Gated global-nearest-neighbor association plus per-track
+ * constant-velocity Kalman filters.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "neighbor_tracker.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_VELOCITY_VARIANCE 1.0
+
+static int compare_pairings(const void *a, const void *b) {
+    real da = ((const TrackPairing *)a)->distance_sq;
+    real db = ((const TrackPairing *)b)->distance_sq;
+    return (da > db) - (da < db);
+}
+
+void tracker_init(NeighborTracker *tracker, real gate, real process_noise,
+                  real measurement_noise) {
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->next_id = 1;
+    tracker->gate = gate;
+    tracker->process_noise = process_noise;
+    tracker->measurement_noise = measurement_noise;
+}
+
+int tracker_is_confirmed(const Track *track) {
+    return track->active && track->hits >= TRACK_CONFIRM_HITS;
+}
+
+// Constant-velocity prediction of one axis with white acceleration noise
+static void predict_axis(real *p, real *v, real cov[3], real dt, real q) {
+    real dt2 = dt * dt;
+    *p += *v * dt;
+    cov[0] += REAL(2.0) * dt * cov[1] + dt2 * cov[2] + q * dt2 * dt / REAL(3.0);
+    cov[1] += dt * cov[2] + q * dt2 / REAL(2.0);
+    cov[2] += q * dt;
+}
+
+// Kalman update of one axis with a position measurement z
+static void update_axis(real *p, real *v, real cov[3], real z, real r) {
+    real s = cov[0] + r;
+    real k0 = cov[0] / s;
+    real k1 = cov[1] / s;
+    real innovation = z - *p;
+    *p += k0 * innovation;
+    *v += k1 * innovation;
+    cov[2] -= k1 * cov[1];
+    cov[1] *= REAL(1.0) - k0;
+    cov[0] *= REAL(1.0) - k0;
+}
+
+static void start_track(NeighborTracker *tracker, Track *track, real x, real y) {
+    track->active = 1;
+    track->id = tracker->next_id++;
+    track->hits = 1;
+    track->misses = 0;
+    track->state[0] = x;
+    track->state[1] = y;
+    track->state[2] = 0.0;
+    track->state[3] = 0.0;
+    for (int axis = 0; axis < 2; axis++) {
+        track->cov[axis][0] = tracker->measurement_noise;
+        track->cov[axis][1] = 0.0;
+        track->cov[axis][2] = INITIAL_VELOCITY_VARIANCE;
+    }
+}
+
+void tracker_update(NeighborTracker *tracker, real dt, const real *det_x,
+                    const real *det_y, int count, int *track_index) {
+    TrackPairing *pairings = tracker->pairings;
+    int track_taken[TRACKER_CAPACITY] = {0};
+    int pairing_count = 0;
+    real gate_sq = tracker->gate * tracker->gate;
+
+    if (count > TRACKER_MAX_DETECTIONS) count = TRACKER_MAX_DETECTIONS;
+    for (int d = 0; d < count; d++) track_index[d] = -1;
+
+    // Predict every live track and collect gated pairings
+    for (int t = 0; t < TRACKER_CAPACITY; t++) {
+        Track *track = &tracker->tracks[t];
+        if (!track->active) continue;
+        predict_axis(&track->state[0], &track->state[2], track->cov[0], dt, tracker->process_noise);
+        predict_axis(&track->state[1], &track->state[3], track->cov[1], dt, tracker->process_noise);
+
+        for (int d = 0; d < count; d++) {
+            real dx = det_x[d] - track->state[0];
+            real dy = det_y[d] - track->state[1];
+            real distance_sq = dx * dx + dy * dy;
+            if (distance_sq < gate_sq) {
+                pairings[pairing_count].distance_sq = distance_sq;
+                pairings[pairing_count].track = t;
+                pairings[pairing_count].detection = d;
+                pairing_count++;
+            }
+        }
+    }
+
+    // Greedy global nearest neighbor: closest pairs claim each other first
+    qsort(pairings, pairing_count, sizeof(TrackPairing), compare_pairings);
+    for (int i = 0; i < pairing_count; i++) {
+        int t = pairings[i].track;
+        int d = pairings[i].detection;
+        if (track_taken[t] || track_index[d] >= 0) continue;
+
+        Track *track = &tracker->tracks[t];
+        update_axis(&track->state[0], &track->state[2], track->cov[0], det_x[d], tracker->measurement_noise);
+        update_axis(&track->state[1], &track->state[3], track->cov[1], det_y[d], tracker->measurement_noise);
+        track->hits++;
+        track->misses = 0;
+        track_taken[t] = 1;
+        track_index[d] = t;
+    }
+
+    // Coast unmatched tracks, dropping the ones lost for too long
+    for (int t = 0; t < TRACKER_CAPACITY; t++) {
+        Track *track = &tracker->tracks[t];
+        if (track->active && !track_taken[t] && ++track->misses > TRACK_MAX_MISSES) {
+            track->active = 0;
+        }
+    }
+
+    // Unmatched detections start new tracks in free slots
+    int free_slot = 0;
+    for (int d = 0; d < count; d++) {
+        if (track_index[d] >= 0) continue;
+        while (free_slot < TRACKER_CAPACITY && tracker->tracks[free_slot].active) free_slot++;
+        if (free_slot == TRACKER_CAPACITY) break;
+        start_track(tracker, &tracker->tracks[free_slot], det_x[d], det_y[d]);
+        track_index[d] = free_slot;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * ChuhaBot Neighbor Tracker
+ * =========================
+ *
+ * Fixed-capacity multi-target tracker giving LIDAR neighbors stable IDs
+ * across control steps. Detections are associated to tracks by gated
+ * global-nearest-neighbor matching, and every track runs a small
+ * constant-velocity Kalman filter over (x, y, vx, vy) in the robot frame.
+ *
+ * All storage, including the association scratch space, lives inside
+ * NeighborTracker; nothing is allocated at runtime and several trackers can
+ * run in one process.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef NEIGHBOR_TRACKER_H
+#define NEIGHBOR_TRACKER_H
+
+#include "precision.h"
+
+#ifndef TRACKER_CAPACITY
+#define TRACKER_CAPACITY 32
+#endif
+#ifndef TRACKER_MAX_DETECTIONS
+#define TRACKER_MAX_DETECTIONS 32
+#endif
+#define TRACK_CONFIRM_HITS 3      // Updates before a track's velocity is trusted
+#define TRACK_MAX_MISSES 5        // Steps a track may coast without a detection
+
+// One tracked neighbor. The 4-state constant-velocity filter keeps x and y
+// independent (diagonal noise), so its covariance is stored as two 2x2
+// position/velocity blocks.
+typedef struct {
+    int active;
+    int id;
+    int hits;
+    int misses;
+    real state[4];                // x, y, vx, vy
+    real cov[2][3];               // Per axis: var(p), cov(p, v), var(v)
+} Track;
+
+// Candidate detection-to-track pairing inside the gate
+typedef struct {
+    real distance_sq;
+    int track;
+    int detection;
+} TrackPairing;
+
+typedef struct {
+    Track tracks[TRACKER_CAPACITY];
+    TrackPairing pairings[TRACKER_CAPACITY * TRACKER_MAX_DETECTIONS];  // tracker_update() scratch
+    int next_id;
+    real gate;                    // Max association distance (m)
+    real process_noise;           // Acceleration noise spectral density
+    real measurement_noise;       // Position measurement variance (m^2)
+} NeighborTracker;
+
+void tracker_init(NeighborTracker *tracker, real gate, real process_noise,
+                  real measurement_noise);
+
+// Advance all tracks by dt seconds and fold in this step's detections.
+// track_index[i] receives the slot of the track detection i was assigned
+// to, or -1 when the tracker is full.
+void tracker_update(NeighborTracker *tracker, real dt, const real *det_x,
+                    const real *det_y, int count, int *track_index);
+
+// Whether a track has been updated often enough for its velocity to be used
+int tracker_is_confirmed(const Track *track);
+
+#endif
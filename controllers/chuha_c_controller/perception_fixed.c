@@ -0,0 +1,271 @@
+/*
+ * ChuhaBot Fixed-Point Perception
+ * ===============================
+ *
+ * Integer port of process_scan() and track_neighbors() on the millimetre
+ * profile, with the sector map of sector_map.c. Keep the constants in step
+ * with chuha_c_controller.c.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "perception_fixed.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TWO_PI (2 * Q16_PI)
+#define DELTA_THETA Q16(0.1)
+#define DELTA_R_MM2 20000                 // DELTA_R (0.02 m) in mm^2
+#define NEIGHBOR_MIN_RANGE Q16(0.3)
+#define NEIGHBOR_MAX_RANGE Q16(1.5)
+#define OBSTACLE_MIN_RANGE_MM 50
+#define OBSTACLE_MAX_RANGE_MM 400
+#define OBSTACLE_RANGE_OFFSET_MM 50
+#define NORMALIZE_MIN_LENGTH Q16(0.001)
+#define BRAKE_RANGE_MM 150
+#define BRAKE_HALF_ANGLE Q16(0.5)
+#define WHEEL_RADIUS_UM 7500              // Micrometres, so the ego-motion ratios are exact
+#define AXLE_LENGTH_UM 70000
+#define TRACK_GATE Q16(0.2)
+#define TRACK_PROCESS_NOISE Q32(1.0)
+#define TRACK_MEASUREMENT_NOISE Q32(4e-4)
+
+static uint16_t min_mm(uint16_t a, uint16_t b) {
+    return a < b ? a : b;
+}
+
+// Direction of every sector's center
+static q16 center_cos[SECTOR_COUNT], center_sin[SECTOR_COUNT];
+static int tables_ready = 0;
+
+static void build_tables(void) {
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        q16 center = -Q16_PI + (q16)((2 * s + 1) * (int64_t)TWO_PI / (2 * SECTOR_COUNT));
+        center_cos[s] = q16_cos(center);
+        center_sin[s] = q16_sin(center);
+    }
+    tables_ready = 1;
+}
+
+void perception_fixed_init(FixedPerception *perception) {
+    if (!tables_ready) build_tables();
+    tracker_fixed_init(&perception->tracker, TRACK_GATE, TRACK_PROCESS_NOISE, TRACK_MEASUREMENT_NOISE);
+    perception_fixed_clear(perception);
+}
+
+void perception_fixed_set_beams(FixedPerception *perception, int width, q16 fov,
+                                const int *sector_start) {
+    if (width > PERCEPTION_MAX_BEAMS) width = PERCEPTION_MAX_BEAMS;
+    if (width < 0) width = 0;
+    perception->width = width;
+    perception->max_gap = (q16)((int64_t)DELTA_THETA * width * Q16_ONE / fov);
+    perception->beams_per_turn = (q16)((int64_t)TWO_PI * width * Q16_ONE / fov);
+
+    // Beam i looks at -fov / 2 + i * fov / width
+    for (int i = 0; i < width; i++) {
+        q16 angle = (q16)div_round64((int64_t)(2 * i - width) * fov, 2 * width);
+        perception->cos_q15[i] = (int16_t)(((int64_t)q16_cos(angle) * 32767 + 32768) >> 16);
+        perception->sin_q15[i] = (int16_t)(((int64_t)q16_sin(angle) * 32767 + 32768) >> 16);
+    }
+
+    memcpy(perception->sector_start, sector_start, sizeof(perception->sector_start));
+}
+
+// Fill the upper sparse table levels from the per-sector minimums
+static void build_levels(FixedSectorMap *map) {
+    for (int k = 1; k < SECTOR_LEVELS; k++) {
+        int half = 1 << (k - 1);
+        for (int s = 0; s + (1 << k) <= SECTOR_COUNT; s++) {
+            map->min_range_mm[k][s] = min_mm(map->min_range_mm[k - 1][s], map->min_range_mm[k - 1][s + half]);
+        }
+    }
+}
+
+static void build_sector_map(FixedPerception *perception, const uint16_t *hit_range_mm) {
+    FixedSectorMap *map = &perception->sectors;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        uint16_t closest = RANGE_MM_NONE;
+        for (int i = perception->sector_start[s]; i < perception->sector_start[s + 1]; i++) {
+            closest = min_mm(closest, hit_range_mm[i]);
+        }
+        map->min_range_mm[0][s] = closest;
+    }
+    build_levels(map);
+}
+
+// Minimum over sectors first .. last (inclusive, first <= last): two overlapping lookups
+static uint16_t range_min(const FixedSectorMap *map, int first, int last) {
+    int k = 0;
+    while ((2 << k) <= last - first + 1) k++;
+    return min_mm(map->min_range_mm[k][first], map->min_range_mm[k][last - (1 << k) + 1]);
+}
+
+// Closest hit in the counter-clockwise window from -> to, as sector_map_query()
+static uint16_t sector_query(const FixedSectorMap *map, q16 from, q16 to) {
+    int64_t span = ((int64_t)to - from) % TWO_PI;
+    if (span < 0) span += TWO_PI;
+
+    int64_t start = ((int64_t)from + Q16_PI) % TWO_PI;
+    if (start < 0) start += TWO_PI;
+
+    int first = (int)(start * SECTOR_COUNT / TWO_PI);
+    int last = (int)((start + span) * SECTOR_COUNT / TWO_PI);
+    if (first >= SECTOR_COUNT) first = SECTOR_COUNT - 1;
+    if (last - first >= SECTOR_COUNT - 1) {
+        return range_min(map, 0, SECTOR_COUNT - 1);
+    }
+
+    if (last < SECTOR_COUNT) {
+        return range_min(map, first, last);
+    }
+    return min_mm(range_min(map, first, SECTOR_COUNT - 1), range_min(map, 0, last - SECTOR_COUNT));
+}
+
+// sector_map_repulsion() followed by normalize_vector(). The weights
+// 1 / (range + offset) are Q32.32 quotients of millimetres, and the sum of
+// the weighted Q16 directions is kept whole in Q48.
+static void obstacle_repulsion(FixedPerception *perception) {
+    int64_t force_x = 0, force_y = 0;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        uint16_t range_mm = perception->sectors.min_range_mm[0][s];
+        if (range_mm > OBSTACLE_MIN_RANGE_MM && range_mm < OBSTACLE_MAX_RANGE_MM) {
+            int64_t weight = ((int64_t)1000 << 32) / (range_mm + OBSTACLE_RANGE_OFFSET_MM);
+            force_x -= center_cos[s] * weight;
+            force_y -= center_sin[s] * weight;
+        }
+    }
+    perception->obstacle_x = q16_saturate(force_x >> 32);
+    perception->obstacle_y = q16_saturate(force_y >> 32);
+    q16_unit_vector(force_x, force_y, (int64_t)NORMALIZE_MIN_LENGTH << 32,
+                    &perception->obstacle_x, &perception->obstacle_y);
+}
+
+// cluster_hits_mm() of chuha_c_controller.c, with the beam gap compared in Q16
+static int cluster_hits(FixedPerception *perception, const uint16_t *hit_range_mm, int *cluster_count) {
+    FixedCluster *clusters = perception->clusters;
+    int hits = 0;
+    int count = 0;
+
+    for (int i = 0; i < perception->width; i++) {
+        int32_t range = hit_range_mm[i];
+        if (range == RANGE_MM_NONE) continue;
+
+        if (hits == 0 ||
+            !((int64_t)(i - perception->hit_beam[hits - 1]) * Q16_ONE < perception->max_gap &&
+              (int64_t)abs(range - perception->hit_range_mm[hits - 1]) * range < DELTA_R_MM2)) {
+            clusters[count].start = hits;
+            clusters[count].count = 0;
+            clusters[count].wrap_start = 0;
+            clusters[count].wrap_count = 0;
+            count++;
+        }
+
+        perception->hit_x_mm[hits] = (range * perception->cos_q15[i]) >> 15;
+        perception->hit_y_mm[hits] = (range * perception->sin_q15[i]) >> 15;
+        perception->hit_range_mm[hits] = (uint16_t)range;
+        perception->hit_beam[hits] = i;
+        clusters[count - 1].count++;
+        hits++;
+    }
+
+    // Wrap-around merge at +/-PI
+    if (count > 1) {
+        int last = hits - 1;
+        int64_t gap = (int64_t)(perception->hit_beam[0] - perception->hit_beam[last]) * Q16_ONE +
+                      perception->beams_per_turn;
+        if (gap < perception->max_gap &&
+            (int64_t)abs(perception->hit_range_mm[0] - perception->hit_range_mm[last]) *
+                    perception->hit_range_mm[last] < DELTA_R_MM2) {
+            count--;
+            clusters[0].wrap_start = clusters[count].start;
+            clusters[0].wrap_count = clusters[count].count;
+        }
+    }
+
+    *cluster_count = count;
+    return hits;
+}
+
+// Centroid of a cluster, combining the wrapped span if there is one
+static void cluster_centroid(const FixedPerception *perception, const FixedCluster *cluster,
+                             q16 *x, q16 *y) {
+    int32_t sum_x = 0, sum_y = 0;
+    for (int i = cluster->start; i < cluster->start + cluster->count; i++) {
+        sum_x += perception->hit_x_mm[i];
+        sum_y += perception->hit_y_mm[i];
+    }
+    for (int i = cluster->wrap_start; i < cluster->wrap_start + cluster->wrap_count; i++) {
+        sum_x += perception->hit_x_mm[i];
+        sum_y += perception->hit_y_mm[i];
+    }
+    int64_t total_mm = 1000 * (int64_t)(cluster->count + cluster->wrap_count);
+    *x = (q16)div_round64((int64_t)sum_x * Q16_ONE, total_mm);
+    *y = (q16)div_round64((int64_t)sum_y * Q16_ONE, total_mm);
+}
+
+// Stable IDs and velocities from the tracker, with this robot's own motion
+// added back from the last wheel command, as track_neighbors() does
+static void track_neighbors(FixedPerception *perception, q16 dt, q16 left_wheel, q16 right_wheel) {
+    int track_index[TRACKER_MAX_DETECTIONS];
+    int count = perception->count < TRACKER_MAX_DETECTIONS ? perception->count : TRACKER_MAX_DETECTIONS;
+    tracker_fixed_update(&perception->tracker, dt, perception->x, perception->y, count, track_index);
+
+    q16 ego_speed = (q16)div_round64(((int64_t)left_wheel + right_wheel) * WHEEL_RADIUS_UM, 2 * 1000000);
+    q16 yaw_rate = (q16)div_round64(((int64_t)right_wheel - left_wheel) * WHEEL_RADIUS_UM, AXLE_LENGTH_UM);
+
+    // Neighbors past the tracker's capacity stay untracked
+    for (int i = 0; i < perception->count; i++) {
+        int slot = i < count ? track_index[i] : -1;
+        const FixedTrack *track = slot >= 0 ? &perception->tracker.tracks[slot] : NULL;
+        perception->id[i] = track ? track->id : 0;
+        perception->velocity_known[i] = track && tracker_fixed_is_confirmed(track);
+        if (perception->velocity_known[i]) {
+            perception->vx[i] = q16_add(track->state[2], q16_sub(ego_speed, q16_mul(yaw_rate, track->state[1])));
+            perception->vy[i] = q16_add(track->state[3], q16_mul(yaw_rate, track->state[0]));
+        } else {
+            perception->vx[i] = 0;
+            perception->vy[i] = 0;
+        }
+    }
+}
+
+void perception_fixed_scan(FixedPerception *perception, const uint16_t *hit_range_mm, q16 dt,
+                           q16 left_wheel, q16 right_wheel) {
+    build_sector_map(perception, hit_range_mm);
+    obstacle_repulsion(perception);
+    perception->front_blocked =
+        sector_query(&perception->sectors, -BRAKE_HALF_ANGLE, BRAKE_HALF_ANGLE) < BRAKE_RANGE_MM;
+
+    // One neighbor per object, keeping centroids in neighbor range
+    int cluster_count;
+    perception->hit_count = cluster_hits(perception, hit_range_mm, &cluster_count);
+    perception->count = 0;
+    for (int c = 0; c < cluster_count && perception->count < MAX_NEIGHBORS; c++) {
+        q16 x, y;
+        cluster_centroid(perception, &perception->clusters[c], &x, &y);
+        q16 range = q16_length(x, y);
+        if (range > NEIGHBOR_MIN_RANGE && range < NEIGHBOR_MAX_RANGE) {
+            int n = perception->count++;
+            perception->x[n] = x;
+            perception->y[n] = y;
+            perception->range[n] = range;
+            perception->bearing[n] = q16_atan2(y, x);
+        }
+    }
+
+    track_neighbors(perception, dt, left_wheel, right_wheel);
+}
+
+void perception_fixed_clear(FixedPerception *perception) {
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        perception->sectors.min_range_mm[0][s] = RANGE_MM_NONE;
+    }
+    build_levels(&perception->sectors);
+    perception->hit_count = 0;
+    perception->count = 0;
+    perception->obstacle_x = 0;
+    perception->obstacle_y = 0;
+    perception->front_blocked = 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * ChuhaBot Fixed-Point Perception
+ * ===============================
+ *
+ * The controller's scan processing for the fixed-point build, from the
+ * millimetre hit profile on: the polar sector map, obstacle repulsion, the
+ * emergency braking test, hit clustering, neighbor centroids and neighbor
+ * tracking with ego-motion compensation, in integer millimetres and Q16.16
+ * only. Like swarm_fixed.c it has no Webots or libm dependency, so it builds
+ * for the FPU-less ChuhaBot MCU, whose LIDAR driver delivers the profile
+ * that collapse_range_layers_mm() makes from the Webots range image.
+ *
+ * Lengths are meters and angles radians in Q16.16 unless named _mm. All
+ * storage lives inside FixedPerception.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef PERCEPTION_FIXED_H
+#define PERCEPTION_FIXED_H
+
+#include "fixed_point.h"
+#include "scan_kernels.h"         // RANGE_MM_NONE
+#include "sector_map.h"           // SECTOR_COUNT, SECTOR_LEVELS
+#include "tracker_fixed.h"
+
+#define PERCEPTION_MAX_BEAMS 4096 // As MAX_LIDAR_RESOLUTION in chuha_c_controller.c
+#ifndef MAX_NEIGHBORS
+#define MAX_NEIGHBORS 32          // As in chuha_c_controller.c
+#endif
+
+// Hits belonging to one object, as spans of the compacted hit arrays. An
+// object straddling the +/-PI seam also owns a wrapped span at the end.
+typedef struct {
+    int start, count;
+    int wrap_start, wrap_count;
+} FixedCluster;
+
+// SectorMap in millimetres: min_range_mm[k][s] = closest hit in sectors
+// s .. s + 2^k - 1, RANGE_MM_NONE if none
+typedef struct {
+    uint16_t min_range_mm[SECTOR_LEVELS][SECTOR_COUNT];
+} FixedSectorMap;
+
+typedef struct {
+    // Beam geometry, set by perception_fixed_set_beams()
+    int width;
+    q16 max_gap;                          // Clustering angle gap, in beams
+    q16 beams_per_turn;
+    int16_t cos_q15[PERCEPTION_MAX_BEAMS];
+    int16_t sin_q15[PERCEPTION_MAX_BEAMS];
+    int sector_start[SECTOR_COUNT + 1];   // First beam of every sector
+
+    // Hits of the last scan in angular order, and their clusters
+    int hit_count;
+    int32_t hit_x_mm[PERCEPTION_MAX_BEAMS];
+    int32_t hit_y_mm[PERCEPTION_MAX_BEAMS];
+    uint16_t hit_range_mm[PERCEPTION_MAX_BEAMS];
+    int hit_beam[PERCEPTION_MAX_BEAMS];
+    FixedCluster clusters[PERCEPTION_MAX_BEAMS];
+
+    FixedSectorMap sectors;
+    FixedTracker tracker;
+
+    // Neighbors of the last scan, one per cluster in neighbor range
+    int count;
+    q16 x[MAX_NEIGHBORS], y[MAX_NEIGHBORS];
+    q16 range[MAX_NEIGHBORS], bearing[MAX_NEIGHBORS];
+    q16 vx[MAX_NEIGHBORS], vy[MAX_NEIGHBORS];     // Own velocity in this robot's frame, 0 unless known
+    int id[MAX_NEIGHBORS];                        // Stable track ID, 0 if untracked
+    int velocity_known[MAX_NEIGHBORS];
+    q16 obstacle_x, obstacle_y;                   // Unit obstacle repulsion
+    int front_blocked;                            // Hit inside the braking window
+} FixedPerception;
+
+// Start the tracker and clear the results; the beam geometry is left alone
+void perception_fixed_init(FixedPerception *perception);
+
+// Beam geometry: width beams spread evenly over fov radians (0 < fov <=
+// 2 * PI), centered straight ahead, as build_beam_tables() lays them out.
+// sector_start holds the first beam of every sector and the end, as
+// sector_map_bounds() gives them, so both builds draw the sector edges
+// through the same beams; on the MCU they come with the LIDAR configuration.
+void perception_fixed_set_beams(FixedPerception *perception, int width, q16 fov,
+                                const int *sector_start);
+
+// Process one millimetre hit profile (perception->width beams,
+// RANGE_MM_NONE = no hit), dt seconds after the previous one. The wheel
+// velocities are the last motor command (rad/s), for the ego-motion
+// compensation of the tracked velocities.
+void perception_fixed_scan(FixedPerception *perception, const uint16_t *hit_range_mm, q16 dt,
+                           q16 left_wheel, q16 right_wheel);
+
+// No scan: empty sector map, no neighbors and no obstacle force
+void perception_fixed_clear(FixedPerception *perception);
+
+#endif
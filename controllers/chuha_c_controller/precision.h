@@ -0,0 +1,66 @@
+/*
+ * ChuhaBot Precision Selection
+ * ============================
+ *
+ * Scalar type of the controller math. The default build computes in
+ * double; building with PRECISION_FLOAT (make PRECISION=float) switches
+ * every behavior, tracking and steering calculation to float, which
+ * halves the operand width of the vectorized loops. The LIDAR delivers
+ * float ranges, so no input precision is lost.
+ *
+ * Literals are written REAL(0.5) so they do not promote float math to
+ * double, and the libm calls go through the REAL_* names.
+ *
+ * MATH_TIER_FAST (make MATH=fast) routes atan2, sin, cos and the reciprocal
+ * square root of normalization through the polynomial approximations in
+ * fast_math.h instead of libm; their error bounds are listed there.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include <math.h>
+
+#ifdef PRECISION_FLOAT
+typedef float real;
+#define REAL_NAME "float"
+#define REAL_SQRT sqrtf
+#define REAL_SIN sinf
+#define REAL_COS cosf
+#define REAL_ATAN2 atan2f
+#define REAL_FABS fabsf
+#define REAL_FMIN fminf
+#define REAL_FMAX fmaxf
+#else
+typedef double real;
+#define REAL_NAME "double"
+#define REAL_SQRT sqrt
+#define REAL_SIN sin
+#define REAL_COS cos
+#define REAL_ATAN2 atan2
+#define REAL_FABS fabs
+#define REAL_FMIN fmin
+#define REAL_FMAX fmax
+#endif
+
+#define REAL(x) ((real)(x))
+
+#ifdef MATH_TIER_FAST
+#include "fast_math.h"
+#undef REAL_SIN
+#undef REAL_COS
+#undef REAL_ATAN2
+#define REAL_SIN(a) ((real)fast_sinf((float)(a)))
+#define REAL_COS(a) ((real)fast_cosf((float)(a)))
+#define REAL_ATAN2(y, x) ((real)fast_atan2f((float)(y), (float)(x)))
+#define REAL_RSQRT(v) ((real)fast_rsqrtf((float)(v)))
+#define MATH_TIER_NAME "fast"
+#else
+#define REAL_RSQRT(v) (REAL(1.0) / REAL_SQRT(v))
+#define MATH_TIER_NAME "exact"
+#endif
+
+#endif
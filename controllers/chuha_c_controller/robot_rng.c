@@ -0,0 +1,42 @@
+/*
+ * ChuhaBot Robot Random Number Generator
+ * ======================================
+ *
+ * PCG32 step and output permutation.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "robot_rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+void rng_seed(RobotRng *rng, uint64_t seed, uint64_t stream) {
+    rng->state = 0;
+    rng->increment = (stream << 1) | 1;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+uint32_t rng_next(RobotRng *rng) {
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + rng->increment;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rotation = (uint32_t)(old >> 59);
+    return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+}
+
+float rng_uniform(RobotRng *rng) {
+    return (rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+uint64_t rng_hash_string(const char *text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *text; text++) {
+        hash ^= (unsigned char)*text;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
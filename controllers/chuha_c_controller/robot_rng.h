@@ -0,0 +1,36 @@
+/*
+ * ChuhaBot Robot Random Number Generator
+ * ======================================
+ *
+ * Small per-robot PCG32 generator (O'Neill's PCG-XSH-RR, 64-bit state).
+ * Each robot owns its generator, so no global lock is involved and
+ * robots driven from one process do not share a sequence. The same seed
+ * and stream always reproduce the same sequence bit for bit.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef ROBOT_RNG_H
+#define ROBOT_RNG_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t state;
+    uint64_t increment;         // Selects the stream, always odd
+} RobotRng;
+
+// Start the generator at seed on the given stream. Different streams with
+// the same seed give independent sequences.
+void rng_seed(RobotRng *rng, uint64_t seed, uint64_t stream);
+
+uint32_t rng_next(RobotRng *rng);
+
+// Uniform in [0, 1), 24-bit resolution so it is exact in float and double
+float rng_uniform(RobotRng *rng);
+
+// FNV-1a hash of a string, for seeding from a robot name
+uint64_t rng_hash_string(const char *text);
+
+#endif
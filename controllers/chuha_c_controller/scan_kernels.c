@@ -0,0 +1,655 @@
+/*
+ * ChuhaBot Scan Kernels
+ * =====================
+ *
+ * Scalar reference and SIMD variants of the scan pipeline kernels.
+ * Each SIMD variant processes full vectors and hands the remaining
+ * tail beams to the scalar reference.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "scan_kernels.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_KERNELS_X86 1
+#define TARGET(isa) __attribute__((target(isa)))
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SCAN_KERNELS_X86 1
+#define TARGET(isa)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#define SCAN_KERNELS_X86 0
+#endif
+
+// ---------------------------------------------------------------------------
+// Scalar reference
+// ---------------------------------------------------------------------------
+
+static void layer_min_filter_scalar(float *profile, const float *row, float threshold, int n) {
+    for (int i = 0; i < n; i++) {
+        float hit = (row[i] < threshold) ? row[i] : FLT_MAX;
+        profile[i] = (hit < profile[i]) ? hit : profile[i];
+    }
+}
+
+static void baseline_min_filter_scalar(float *profile, const float *row, const float *baseline,
+                                       float scale, int n) {
+    for (int i = 0; i < n; i++) {
+        float hit = (row[i] < baseline[i] * scale) ? row[i] : FLT_MAX;
+        profile[i] = (hit < profile[i]) ? hit : profile[i];
+    }
+}
+
+static void polar_to_cartesian_scalar(const float *range, const float *cos_a, const float *sin_a,
+                                      float *x, float *y, int n) {
+    for (int i = 0; i < n; i++) {
+        x[i] = range[i] * cos_a[i];
+        y[i] = range[i] * sin_a[i];
+    }
+}
+
+static void point_sum_scalar(const float *x, const float *y, int n, double *sum_x, double *sum_y) {
+    double sx = 0.0, sy = 0.0;
+    for (int i = 0; i < n; i++) {
+        sx += x[i];
+        sy += y[i];
+    }
+    *sum_x = sx;
+    *sum_y = sy;
+}
+
+static void point_centroid_scalar(const float *x, const float *y, int n,
+                                  float *center_x, float *center_y) {
+    double sx, sy;
+    *center_x = 0.0f;
+    *center_y = 0.0f;
+    if (n <= 0) return;
+    point_sum_scalar(x, y, n, &sx, &sy);
+    *center_x = (float)(sx / n);
+    *center_y = (float)(sy / n);
+}
+
+static uint16_t quantize_mm(float range) {
+    float v = range * 1000.0f + 0.5f;
+    return (v < 65535.0f) ? (uint16_t)v : RANGE_MM_NONE;
+}
+
+static void layer_min_filter_mm_scalar(uint16_t *profile, const float *row, uint16_t threshold, int n) {
+    for (int i = 0; i < n; i++) {
+        uint16_t mm = quantize_mm(row[i]);
+        uint16_t hit = (mm < threshold) ? mm : RANGE_MM_NONE;
+        profile[i] = (hit < profile[i]) ? hit : profile[i];
+    }
+}
+
+static void threshold_min_filter_mm_scalar(uint16_t *profile, const float *row,
+                                           const uint16_t *threshold, int n) {
+    for (int i = 0; i < n; i++) {
+        uint16_t mm = quantize_mm(row[i]);
+        uint16_t hit = (mm < threshold[i]) ? mm : RANGE_MM_NONE;
+        profile[i] = (hit < profile[i]) ? hit : profile[i];
+    }
+}
+
+#if SCAN_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// SSE2 (4 float / 8 uint16 lanes)
+// ---------------------------------------------------------------------------
+
+TARGET("sse2")
+static float hsum_sse2(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+TARGET("sse2")
+static void layer_min_filter_sse2(float *profile, const float *row, float threshold, int n) {
+    const __m128 thr = _mm_set1_ps(threshold);
+    const __m128 none = _mm_set1_ps(FLT_MAX);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 r = _mm_loadu_ps(row + i);
+        __m128 mask = _mm_cmplt_ps(r, thr);
+        __m128 hit = _mm_or_ps(_mm_and_ps(mask, r), _mm_andnot_ps(mask, none));
+        _mm_storeu_ps(profile + i, _mm_min_ps(_mm_loadu_ps(profile + i), hit));
+    }
+    layer_min_filter_scalar(profile + i, row + i, threshold, n - i);
+}
+
+TARGET("sse2")
+static void baseline_min_filter_sse2(float *profile, const float *row, const float *baseline,
+                                     float scale, int n) {
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128 none = _mm_set1_ps(FLT_MAX);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 r = _mm_loadu_ps(row + i);
+        __m128 mask = _mm_cmplt_ps(r, _mm_mul_ps(_mm_loadu_ps(baseline + i), vscale));
+        __m128 hit = _mm_or_ps(_mm_and_ps(mask, r), _mm_andnot_ps(mask, none));
+        _mm_storeu_ps(profile + i, _mm_min_ps(_mm_loadu_ps(profile + i), hit));
+    }
+    baseline_min_filter_scalar(profile + i, row + i, baseline + i, scale, n - i);
+}
+
+TARGET("sse2")
+static void polar_to_cartesian_sse2(const float *range, const float *cos_a, const float *sin_a,
+                                    float *x, float *y, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 r = _mm_loadu_ps(range + i);
+        _mm_storeu_ps(x + i, _mm_mul_ps(r, _mm_loadu_ps(cos_a + i)));
+        _mm_storeu_ps(y + i, _mm_mul_ps(r, _mm_loadu_ps(sin_a + i)));
+    }
+    polar_to_cartesian_scalar(range + i, cos_a + i, sin_a + i, x + i, y + i, n - i);
+}
+
+TARGET("sse2")
+static void point_centroid_sse2(const float *x, const float *y, int n,
+                                float *center_x, float *center_y) {
+    __m128 sx = _mm_setzero_ps(), sy = _mm_setzero_ps();
+    double tail_x, tail_y;
+    int i = 0;
+    *center_x = 0.0f;
+    *center_y = 0.0f;
+    if (n <= 0) return;
+    for (; i + 4 <= n; i += 4) {
+        sx = _mm_add_ps(sx, _mm_loadu_ps(x + i));
+        sy = _mm_add_ps(sy, _mm_loadu_ps(y + i));
+    }
+    point_sum_scalar(x + i, y + i, n - i, &tail_x, &tail_y);
+    *center_x = (float)((hsum_sse2(sx) + tail_x) / n);
+    *center_y = (float)((hsum_sse2(sy) + tail_y) / n);
+}
+
+// SSE2 has only signed 16-bit compares and min: flip the sign bit to order
+// unsigned values correctly
+TARGET("sse2")
+static __m128i min_hit_mm_sse2(__m128i profile, __m128i row, __m128i threshold) {
+    const __m128i bias = _mm_set1_epi16((short)0x8000);
+    __m128i below = _mm_cmplt_epi16(_mm_xor_si128(row, bias), _mm_xor_si128(threshold, bias));
+    __m128i hit = _mm_or_si128(row, _mm_xor_si128(below, _mm_set1_epi16(-1)));
+    __m128i lowest = _mm_min_epi16(_mm_xor_si128(profile, bias), _mm_xor_si128(hit, bias));
+    return _mm_xor_si128(lowest, bias);
+}
+
+// Eight ranges to millimetres, saturating as quantize_mm() does
+TARGET("sse2")
+static __m128i quantize_mm_sse2(const float *range) {
+    const __m128 scale = _mm_set1_ps(1000.0f), half = _mm_set1_ps(0.5f);
+    const __m128 limit = _mm_set1_ps(65535.0f);
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    // min() returns the limit for NaN, so no-return beams saturate too
+    __m128 a = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(range), scale), half), limit);
+    __m128 b = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(range + 4), scale), half), limit);
+    __m128i packed = _mm_packs_epi32(_mm_sub_epi32(_mm_cvttps_epi32(a), bias32),
+                                     _mm_sub_epi32(_mm_cvttps_epi32(b), bias32));
+    return _mm_xor_si128(packed, bias16);
+}
+
+TARGET("sse2")
+static void layer_min_filter_mm_sse2(uint16_t *profile, const float *row, uint16_t threshold, int n) {
+    const __m128i thr = _mm_set1_epi16((short)threshold);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(profile + i));
+        __m128i r = quantize_mm_sse2(row + i);
+        _mm_storeu_si128((__m128i *)(profile + i), min_hit_mm_sse2(p, r, thr));
+    }
+    layer_min_filter_mm_scalar(profile + i, row + i, threshold, n - i);
+}
+
+TARGET("sse2")
+static void threshold_min_filter_mm_sse2(uint16_t *profile, const float *row,
+                                         const uint16_t *threshold, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(profile + i));
+        __m128i r = quantize_mm_sse2(row + i);
+        __m128i t = _mm_loadu_si128((const __m128i *)(threshold + i));
+        _mm_storeu_si128((__m128i *)(profile + i), min_hit_mm_sse2(p, r, t));
+    }
+    threshold_min_filter_mm_scalar(profile + i, row + i, threshold + i, n - i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 (8 float / 16 uint16 lanes)
+// ---------------------------------------------------------------------------
+
+TARGET("avx2")
+static float hsum_avx2(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum_sse2(_mm_add_ps(lo, hi));
+}
+
+TARGET("avx2")
+static void layer_min_filter_avx2(float *profile, const float *row, float threshold, int n) {
+    const __m256 thr = _mm256_set1_ps(threshold);
+    const __m256 none = _mm256_set1_ps(FLT_MAX);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 r = _mm256_loadu_ps(row + i);
+        __m256 hit = _mm256_blendv_ps(none, r, _mm256_cmp_ps(r, thr, _CMP_LT_OQ));
+        _mm256_storeu_ps(profile + i, _mm256_min_ps(_mm256_loadu_ps(profile + i), hit));
+    }
+    layer_min_filter_scalar(profile + i, row + i, threshold, n - i);
+}
+
+TARGET("avx2")
+static void baseline_min_filter_avx2(float *profile, const float *row, const float *baseline,
+                                     float scale, int n) {
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 none = _mm256_set1_ps(FLT_MAX);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 r = _mm256_loadu_ps(row + i);
+        __m256 thr = _mm256_mul_ps(_mm256_loadu_ps(baseline + i), vscale);
+        __m256 hit = _mm256_blendv_ps(none, r, _mm256_cmp_ps(r, thr, _CMP_LT_OQ));
+        _mm256_storeu_ps(profile + i, _mm256_min_ps(_mm256_loadu_ps(profile + i), hit));
+    }
+    baseline_min_filter_scalar(profile + i, row + i, baseline + i, scale, n - i);
+}
+
+TARGET("avx2")
+static void polar_to_cartesian_avx2(const float *range, const float *cos_a, const float *sin_a,
+                                    float *x, float *y, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 r = _mm256_loadu_ps(range + i);
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(r, _mm256_loadu_ps(cos_a + i)));
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(r, _mm256_loadu_ps(sin_a + i)));
+    }
+    polar_to_cartesian_scalar(range + i, cos_a + i, sin_a + i, x + i, y + i, n - i);
+}
+
+TARGET("avx2")
+static void point_centroid_avx2(const float *x, const float *y, int n,
+                                float *center_x, float *center_y) {
+    __m256 sx = _mm256_setzero_ps(), sy = _mm256_setzero_ps();
+    double tail_x, tail_y;
+    int i = 0;
+    *center_x = 0.0f;
+    *center_y = 0.0f;
+    if (n <= 0) return;
+    for (; i + 8 <= n; i += 8) {
+        sx = _mm256_add_ps(sx, _mm256_loadu_ps(x + i));
+        sy = _mm256_add_ps(sy, _mm256_loadu_ps(y + i));
+    }
+    point_sum_scalar(x + i, y + i, n - i, &tail_x, &tail_y);
+    *center_x = (float)((hsum_avx2(sx) + tail_x) / n);
+    *center_y = (float)((hsum_avx2(sy) + tail_y) / n);
+}
+
+// row >= threshold exactly where max(row, threshold) == row; those beams become RANGE_MM_NONE
+TARGET("avx2")
+static __m256i min_hit_mm_avx2(__m256i profile, __m256i row, __m256i threshold) {
+    __m256i not_below = _mm256_cmpeq_epi16(_mm256_max_epu16(row, threshold), row);
+    return _mm256_min_epu16(profile, _mm256_or_si256(row, not_below));
+}
+
+// Sixteen ranges to millimetres, saturating as quantize_mm() does
+TARGET("avx2")
+static __m256i quantize_mm_avx2(const float *range) {
+    const __m256 scale = _mm256_set1_ps(1000.0f), half = _mm256_set1_ps(0.5f);
+    const __m256 limit = _mm256_set1_ps(65535.0f);
+    __m256 a = _mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(range), scale), half), limit);
+    __m256 b = _mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(range + 8), scale), half), limit);
+    // packus interleaves 128-bit lanes; restore beam order afterwards
+    __m256i packed = _mm256_packus_epi32(_mm256_cvttps_epi32(a), _mm256_cvttps_epi32(b));
+    return _mm256_permute4x64_epi64(packed, 0xD8);
+}
+
+TARGET("avx2")
+static void layer_min_filter_mm_avx2(uint16_t *profile, const float *row, uint16_t threshold, int n) {
+    const __m256i thr = _mm256_set1_epi16((short)threshold);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(profile + i));
+        __m256i r = quantize_mm_avx2(row + i);
+        _mm256_storeu_si256((__m256i *)(profile + i), min_hit_mm_avx2(p, r, thr));
+    }
+    layer_min_filter_mm_scalar(profile + i, row + i, threshold, n - i);
+}
+
+TARGET("avx2")
+static void threshold_min_filter_mm_avx2(uint16_t *profile, const float *row,
+                                         const uint16_t *threshold, int n) {
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(profile + i));
+        __m256i r = quantize_mm_avx2(row + i);
+        __m256i t = _mm256_loadu_si256((const __m256i *)(threshold + i));
+        _mm256_storeu_si256((__m256i *)(profile + i), min_hit_mm_avx2(p, r, t));
+    }
+    threshold_min_filter_mm_scalar(profile + i, row + i, threshold + i, n - i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512 (16 float / 32 uint16 lanes, needs AVX512F + AVX512BW)
+// ---------------------------------------------------------------------------
+
+TARGET("avx512f")
+static void layer_min_filter_avx512(float *profile, const float *row, float threshold, int n) {
+    const __m512 thr = _mm512_set1_ps(threshold);
+    const __m512 none = _mm512_set1_ps(FLT_MAX);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 r = _mm512_loadu_ps(row + i);
+        __m512 hit = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(r, thr, _CMP_LT_OQ), none, r);
+        _mm512_storeu_ps(profile + i, _mm512_min_ps(_mm512_loadu_ps(profile + i), hit));
+    }
+    layer_min_filter_scalar(profile + i, row + i, threshold, n - i);
+}
+
+TARGET("avx512f")
+static void baseline_min_filter_avx512(float *profile, const float *row, const float *baseline,
+                                       float scale, int n) {
+    const __m512 vscale = _mm512_set1_ps(scale);
+    const __m512 none = _mm512_set1_ps(FLT_MAX);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 r = _mm512_loadu_ps(row + i);
+        __m512 thr = _mm512_mul_ps(_mm512_loadu_ps(baseline + i), vscale);
+        __m512 hit = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(r, thr, _CMP_LT_OQ), none, r);
+        _mm512_storeu_ps(profile + i, _mm512_min_ps(_mm512_loadu_ps(profile + i), hit));
+    }
+    baseline_min_filter_scalar(profile + i, row + i, baseline + i, scale, n - i);
+}
+
+TARGET("avx512f")
+static void polar_to_cartesian_avx512(const float *range, const float *cos_a, const float *sin_a,
+                                      float *x, float *y, int n) {
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 r = _mm512_loadu_ps(range + i);
+        _mm512_storeu_ps(x + i, _mm512_mul_ps(r, _mm512_loadu_ps(cos_a + i)));
+        _mm512_storeu_ps(y + i, _mm512_mul_ps(r, _mm512_loadu_ps(sin_a + i)));
+    }
+    polar_to_cartesian_scalar(range + i, cos_a + i, sin_a + i, x + i, y + i, n - i);
+}
+
+TARGET("avx512f")
+static void point_centroid_avx512(const float *x, const float *y, int n,
+                                  float *center_x, float *center_y) {
+    __m512 sx = _mm512_setzero_ps(), sy = _mm512_setzero_ps();
+    double tail_x, tail_y;
+    int i = 0;
+    *center_x = 0.0f;
+    *center_y = 0.0f;
+    if (n <= 0) return;
+    for (; i + 16 <= n; i += 16) {
+        sx = _mm512_add_ps(sx, _mm512_loadu_ps(x + i));
+        sy = _mm512_add_ps(sy, _mm512_loadu_ps(y + i));
+    }
+    point_sum_scalar(x + i, y + i, n - i, &tail_x, &tail_y);
+    *center_x = (float)((_mm512_reduce_add_ps(sx) + tail_x) / n);
+    *center_y = (float)((_mm512_reduce_add_ps(sy) + tail_y) / n);
+}
+
+TARGET("avx512f,avx512bw")
+static __m512i min_hit_mm_avx512(__m512i profile, __m512i row, __m512i threshold) {
+    __mmask32 below = _mm512_cmplt_epu16_mask(row, threshold);
+    __m512i hit = _mm512_mask_blend_epi16(below, _mm512_set1_epi16(-1), row);
+    return _mm512_min_epu16(profile, hit);
+}
+
+// Thirty-two ranges to millimetres, saturating as quantize_mm() does
+TARGET("avx512f,avx512bw")
+static __m512i quantize_mm_avx512(const float *range) {
+    const __m512 scale = _mm512_set1_ps(1000.0f), half = _mm512_set1_ps(0.5f);
+    const __m512 limit = _mm512_set1_ps(65535.0f);
+    const __m512i order = _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+    __m512 a = _mm512_min_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(range), scale), half), limit);
+    __m512 b = _mm512_min_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(range + 16), scale), half), limit);
+    // packus interleaves 128-bit lanes; restore beam order afterwards
+    __m512i packed = _mm512_packus_epi32(_mm512_cvttps_epi32(a), _mm512_cvttps_epi32(b));
+    return _mm512_permutexvar_epi64(order, packed);
+}
+
+TARGET("avx512f,avx512bw")
+static void layer_min_filter_mm_avx512(uint16_t *profile, const float *row, uint16_t threshold, int n) {
+    const __m512i thr = _mm512_set1_epi16((short)threshold);
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i p = _mm512_loadu_si512(profile + i);
+        __m512i r = quantize_mm_avx512(row + i);
+        _mm512_storeu_si512(profile + i, min_hit_mm_avx512(p, r, thr));
+    }
+    layer_min_filter_mm_scalar(profile + i, row + i, threshold, n - i);
+}
+
+TARGET("avx512f,avx512bw")
+static void threshold_min_filter_mm_avx512(uint16_t *profile, const float *row,
+                                           const uint16_t *threshold, int n) {
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512i p = _mm512_loadu_si512(profile + i);
+        __m512i r = quantize_mm_avx512(row + i);
+        __m512i t = _mm512_loadu_si512(threshold + i);
+        _mm512_storeu_si512(profile + i, min_hit_mm_avx512(p, r, t));
+    }
+    threshold_min_filter_mm_scalar(profile + i, row + i, threshold + i, n - i);
+}
+
+#endif // SCAN_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+enum { VARIANT_SCALAR, VARIANT_SSE2, VARIANT_AVX2, VARIANT_AVX512, VARIANT_COUNT };
+
+static const ScanKernels variants[VARIANT_COUNT] = {
+    { "scalar", layer_min_filter_scalar, baseline_min_filter_scalar,
+      polar_to_cartesian_scalar, point_centroid_scalar,
+      layer_min_filter_mm_scalar, threshold_min_filter_mm_scalar },
+#if SCAN_KERNELS_X86
+    { "sse2", layer_min_filter_sse2, baseline_min_filter_sse2,
+      polar_to_cartesian_sse2, point_centroid_sse2,
+      layer_min_filter_mm_sse2, threshold_min_filter_mm_sse2 },
+    { "avx2", layer_min_filter_avx2, baseline_min_filter_avx2,
+      polar_to_cartesian_avx2, point_centroid_avx2,
+      layer_min_filter_mm_avx2, threshold_min_filter_mm_avx2 },
+    { "avx512", layer_min_filter_avx512, baseline_min_filter_avx512,
+      polar_to_cartesian_avx512, point_centroid_avx512,
+      layer_min_filter_mm_avx512, threshold_min_filter_mm_avx512 },
+#endif
+};
+
+ScanKernels scan_kernels = {
+    "scalar", layer_min_filter_scalar, baseline_min_filter_scalar,
+    polar_to_cartesian_scalar, point_centroid_scalar,
+    layer_min_filter_mm_scalar, threshold_min_filter_mm_scalar
+};
+
+#if SCAN_KERNELS_X86
+static void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    __cpuidex((int *)regs, (int)leaf, (int)subleaf);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static unsigned long long xgetbv0(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+#endif
+
+// Highest variant both the CPU and the OS (saved register state) support
+static int detect_variant(void) {
+    int best = VARIANT_SCALAR;
+#if SCAN_KERNELS_X86
+    unsigned int regs[4];
+
+    cpuid(0, 0, regs);
+    unsigned int max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    if (!(regs[3] & (1u << 26))) return best;              // SSE2
+    best = VARIANT_SSE2;
+
+    int osxsave = (regs[2] & (1u << 27)) != 0;
+    int avx = (regs[2] & (1u << 28)) != 0;
+    if (!osxsave || !avx || max_leaf < 7) return best;
+
+    unsigned long long xcr0 = xgetbv0();
+    if ((xcr0 & 0x6) != 0x6) return best;                  // XMM + YMM state
+
+    cpuid(7, 0, regs);
+    if (regs[1] & (1u << 5)) best = VARIANT_AVX2;
+    if ((regs[1] & (1u << 16)) && (regs[1] & (1u << 30)) &&  // AVX512F + AVX512BW
+        (xcr0 & 0xE6) == 0xE6) {                             // + ZMM state
+        best = VARIANT_AVX512;
+    }
+#endif
+    return best;
+}
+
+static int active_variant = -1;
+
+void scan_kernels_init(void) {
+    if (active_variant >= 0) return;
+    active_variant = detect_variant();
+    scan_kernels = variants[active_variant];
+}
+
+// ---------------------------------------------------------------------------
+// Self-check against the scalar reference
+// ---------------------------------------------------------------------------
+
+#define CHECK_BEAMS 515  // Not a multiple of any vector width, exercises the tails
+
+static int check_close(const char *variant, const char *kernel, double expected, double actual,
+                       float tolerance) {
+    double scale = fabs(expected) > 1.0 ? fabs(expected) : 1.0;
+    if (fabs(expected - actual) <= tolerance * scale) return 0;
+    printf("scan_kernels: %s %s mismatch (expected %g, got %g)\n",
+           variant, kernel, expected, actual);
+    return 1;
+}
+
+int scan_kernels_self_check(float tolerance) {
+    static float range[CHECK_BEAMS], cos_a[CHECK_BEAMS], sin_a[CHECK_BEAMS];
+    static float baseline[CHECK_BEAMS];
+    static float ref_profile[CHECK_BEAMS], profile[CHECK_BEAMS];
+    static float ref_baseline_profile[CHECK_BEAMS];
+    static float ref_x[CHECK_BEAMS], ref_y[CHECK_BEAMS], x[CHECK_BEAMS], y[CHECK_BEAMS];
+    static float raw[CHECK_BEAMS];
+    static uint16_t thresholds_mm[CHECK_BEAMS], ref_mm[CHECK_BEAMS], profile_mm[CHECK_BEAMS];
+    static uint16_t ref_layer_mm[CHECK_BEAMS], ref_threshold_mm[CHECK_BEAMS];
+
+    for (int i = 0; i < CHECK_BEAMS; i++) {
+        double angle = (double)i / CHECK_BEAMS * 2.0 * 3.14159265359 - 3.14159265359;
+        cos_a[i] = (float)cos(angle);
+        sin_a[i] = (float)sin(angle);
+        range[i] = (float)(0.1 + 0.9 * fabs(sin(i * 0.37)));
+        baseline[i] = (float)(0.2 + 1.0 * fabs(cos(i * 0.11)));
+        // Raw readings with no-return and out-of-range beams for the millimetre kernels
+        raw[i] = (i % 37 == 0) ? INFINITY : (i % 53 == 0) ? 70.0f : range[i] * 4.0f;
+        thresholds_mm[i] = (uint16_t)(baseline[i] * 1500.0f);
+    }
+
+    const ScanKernels *ref = &variants[VARIANT_SCALAR];
+    float ref_cx, ref_cy;
+    for (int i = 0; i < CHECK_BEAMS; i++) ref_profile[i] = ref_baseline_profile[i] = FLT_MAX;
+    ref->layer_min_filter(ref_profile, range, 0.6f, CHECK_BEAMS);
+    ref->baseline_min_filter(ref_baseline_profile, range, baseline, 0.6f, CHECK_BEAMS);
+    ref->polar_to_cartesian(range, cos_a, sin_a, ref_x, ref_y, CHECK_BEAMS);
+    ref->point_centroid(ref_x, ref_y, CHECK_BEAMS, &ref_cx, &ref_cy);
+    // With the threshold at RANGE_MM_NONE the filter is the bare quantization
+    for (int i = 0; i < CHECK_BEAMS; i++) ref_mm[i] = ref_layer_mm[i] = ref_threshold_mm[i] = RANGE_MM_NONE;
+    ref->layer_min_filter_mm(ref_mm, raw, RANGE_MM_NONE, CHECK_BEAMS);
+    ref->layer_min_filter_mm(ref_layer_mm, raw, 1200, CHECK_BEAMS);
+    ref->threshold_min_filter_mm(ref_threshold_mm, raw, thresholds_mm, CHECK_BEAMS);
+
+    int failures = 0;
+    int top = active_variant >= 0 ? active_variant : detect_variant();
+    for (int v = VARIANT_SCALAR + 1; v <= top; v++) {
+        const ScanKernels *k = &variants[v];
+        float cx, cy;
+
+        for (int i = 0; i < CHECK_BEAMS; i++) profile[i] = FLT_MAX;
+        k->layer_min_filter(profile, range, 0.6f, CHECK_BEAMS);
+        for (int i = 0; i < CHECK_BEAMS; i++) {
+            if (profile[i] != ref_profile[i]) {
+                failures += check_close(k->name, "layer_min_filter", ref_profile[i], profile[i], 0.0f);
+                break;
+            }
+        }
+
+        for (int i = 0; i < CHECK_BEAMS; i++) profile[i] = FLT_MAX;
+        k->baseline_min_filter(profile, range, baseline, 0.6f, CHECK_BEAMS);
+        for (int i = 0; i < CHECK_BEAMS; i++) {
+            if (profile[i] != ref_baseline_profile[i]) {
+                failures += check_close(k->name, "baseline_min_filter", ref_baseline_profile[i],
+                                        profile[i], 0.0f);
+                break;
+            }
+        }
+
+        k->polar_to_cartesian(range, cos_a, sin_a, x, y, CHECK_BEAMS);
+        for (int i = 0; i < CHECK_BEAMS; i++) {
+            if (check_close(k->name, "polar_to_cartesian", ref_x[i], x[i], tolerance) ||
+                check_close(k->name, "polar_to_cartesian", ref_y[i], y[i], tolerance)) {
+                failures++;
+                break;
+            }
+        }
+
+        k->point_centroid(ref_x, ref_y, CHECK_BEAMS, &cx, &cy);
+        failures += check_close(k->name, "point_centroid", ref_cx, cx, tolerance) |
+                    check_close(k->name, "point_centroid", ref_cy, cy, tolerance);
+
+        // Millimetre kernels are integer and must match exactly
+        for (int i = 0; i < CHECK_BEAMS; i++) profile_mm[i] = RANGE_MM_NONE;
+        k->layer_min_filter_mm(profile_mm, raw, RANGE_MM_NONE, CHECK_BEAMS);
+        for (int i = 0; i < CHECK_BEAMS; i++) {
+            if (profile_mm[i] != ref_mm[i]) {
+                failures += check_close(k->name, "layer_min_filter_mm quantization", ref_mm[i],
+                                        profile_mm[i], 0.0f);
+                break;
+            }
+        }
+
+        for (int i = 0; i < CHECK_BEAMS; i++) profile_mm[i] = RANGE_MM_NONE;
+        k->layer_min_filter_mm(profile_mm, raw, 1200, CHECK_BEAMS);
+        for (int i = 0; i < CHECK_BEAMS; i++) {
+            if (profile_mm[i] != ref_layer_mm[i]) {
+                failures += check_close(k->name, "layer_min_filter_mm", ref_layer_mm[i], profile_mm[i], 0.0f);
+                break;
+            }
+        }
+
+        for (int i = 0; i < CHECK_BEAMS; i++) profile_mm[i] = RANGE_MM_NONE;
+        k->threshold_min_filter_mm(profile_mm, raw, thresholds_mm, CHECK_BEAMS);
+        for (int i = 0; i < CHECK_BEAMS; i++) {
+            if (profile_mm[i] != ref_threshold_mm[i]) {
+                failures += check_close(k->name, "threshold_min_filter_mm", ref_threshold_mm[i],
+                                        profile_mm[i], 0.0f);
+                break;
+            }
+        }
+    }
+    return failures;
+}
@@ -0,0 +1,65 @@
+/*
+ * ChuhaBot Scan Kernels
+ * =====================
+ *
+ * Hot loops of the LIDAR scan pipeline, with SSE2, AVX2 and AVX-512
+ * variants selected once at startup through CPUID, plus a scalar
+ * reference used on other hosts and as the ground truth for the
+ * self-check.
+ *
+ * All kernels work on contiguous arrays of n beams; no alignment is
+ * required, but 64-byte aligned inputs avoid split loads. The *_mm kernels
+ * serve the millimetre build (RANGE_FIXED_MM): they quantize float rows to
+ * uint16 millimetres on the fly and filter on 16-bit lanes, with twice as
+ * many beams per vector, so no millimetre copy of the scan is stored.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef SCAN_KERNELS_H
+#define SCAN_KERNELS_H
+
+#include <stdint.h>
+
+#define RANGE_MM_NONE 0xFFFF    // No return, or no hit, in the millimetre format
+
+typedef struct {
+    const char *name;
+
+    // profile[i] = min(profile[i], row[i]) for beams where row[i] < threshold
+    void (*layer_min_filter)(float *profile, const float *row, float threshold, int n);
+
+    // Same with a per-beam threshold: beams where row[i] < baseline[i] * scale
+    void (*baseline_min_filter)(float *profile, const float *row, const float *baseline,
+                                float scale, int n);
+
+    // x[i] = range[i] * cos_a[i], y[i] = range[i] * sin_a[i]
+    void (*polar_to_cartesian)(const float *range, const float *cos_a, const float *sin_a,
+                               float *x, float *y, int n);
+
+    // Mean of n points (left at 0, 0 when n == 0)
+    void (*point_centroid)(const float *x, const float *y, int n,
+                           float *center_x, float *center_y);
+
+    // Millimetre filters: each beam of row is first rounded to millimetres,
+    // RANGE_MM_NONE beyond 65.534 m or without a return. Then
+    // profile[i] = min(profile[i], mm) for beams where mm < threshold
+    void (*layer_min_filter_mm)(uint16_t *profile, const float *row, uint16_t threshold, int n);
+
+    // Same with a per-beam threshold: beams where mm < threshold[i]
+    void (*threshold_min_filter_mm)(uint16_t *profile, const float *row,
+                                    const uint16_t *threshold, int n);
+} ScanKernels;
+
+// Kernels selected for this host; valid after scan_kernels_init()
+extern ScanKernels scan_kernels;
+
+// Detect CPU features and select the widest supported variant
+void scan_kernels_init(void);
+
+// Compare every variant supported by this host against the scalar reference
+// on a synthetic scan. Returns the number of kernels outside tolerance.
+int scan_kernels_self_check(float tolerance);
+
+#endif
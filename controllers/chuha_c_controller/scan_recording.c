@@ -0,0 +1,65 @@
+/*
+ * ChuhaBot Scan Recording
+ * =======================
+ *
+ * Writing and reading of recorded LIDAR frames.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "scan_recording.h"
+
+#include <string.h>
+
+#define RECORDING_MAGIC "CHUHASC1"
+
+int scan_recording_create(ScanRecording *recording, const char *path, const BaselineKey *lidar,
+                          int sampling_period, int basic_time_step) {
+    memset(recording, 0, sizeof(*recording));
+    memcpy(recording->header.magic, RECORDING_MAGIC, 8);
+    recording->header.lidar = *lidar;
+    recording->header.sampling_period = sampling_period;
+    recording->header.basic_time_step = basic_time_step;
+    recording->frame_floats = (size_t)lidar->layers * lidar->resolution;
+
+    recording->file = fopen(path, "wb");
+    if (!recording->file) return 0;
+    if (fwrite(&recording->header, sizeof(recording->header), 1, recording->file) != 1) {
+        scan_recording_close(recording);
+        return 0;
+    }
+    return 1;
+}
+
+int scan_recording_write(ScanRecording *recording, const float *range_image) {
+    return fwrite(range_image, sizeof(float), recording->frame_floats, recording->file) ==
+           recording->frame_floats;
+}
+
+int scan_recording_open(ScanRecording *recording, const char *path) {
+    memset(recording, 0, sizeof(*recording));
+    recording->file = fopen(path, "rb");
+    if (!recording->file) return 0;
+
+    const BaselineKey *lidar = &recording->header.lidar;
+    if (fread(&recording->header, sizeof(recording->header), 1, recording->file) != 1 ||
+        memcmp(recording->header.magic, RECORDING_MAGIC, 8) != 0 ||
+        lidar->layers <= 0 || lidar->resolution <= 0 || recording->header.sampling_period <= 0 ||
+        recording->header.basic_time_step <= 0) {
+        scan_recording_close(recording);
+        return 0;
+    }
+    recording->frame_floats = (size_t)lidar->layers * lidar->resolution;
+    return 1;
+}
+
+int scan_recording_read(ScanRecording *recording, float *range_image) {
+    return fread(range_image, sizeof(float), recording->frame_floats, recording->file) ==
+           recording->frame_floats;
+}
+
+void scan_recording_close(ScanRecording *recording) {
+    if (recording->file) fclose(recording->file);
+    recording->file = NULL;
+}
@@ -0,0 +1,55 @@
+/*
+ * ChuhaBot Scan Recording
+ * =======================
+ *
+ * LIDAR range images written to a binary file as they arrive, so a run can
+ * be replayed on the host (host/webots_replay.c) and different builds of
+ * the controller compared on exactly the same scans.
+ *
+ * File layout (native byte order):
+ *   ScanRecordingHeader, then one layers * resolution float frame per
+ *   LIDAR sampling period, layer-major as wb_lidar_get_range_image()
+ *
+ * A 16x512 LIDAR records 32 KB per frame.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef SCAN_RECORDING_H
+#define SCAN_RECORDING_H
+
+#include <stdio.h>
+
+#include "baseline_cache.h"
+
+typedef struct {
+    char magic[8];
+    BaselineKey lidar;          // LIDAR geometry
+    int sampling_period;        // ms between frames
+    int basic_time_step;        // ms, the world's basicTimeStep
+} ScanRecordingHeader;
+
+typedef struct {
+    FILE *file;                 // NULL when closed
+    ScanRecordingHeader header;
+    size_t frame_floats;        // layers * resolution
+} ScanRecording;
+
+// Create a recording at path. Returns 1 on success.
+int scan_recording_create(ScanRecording *recording, const char *path, const BaselineKey *lidar,
+                          int sampling_period, int basic_time_step);
+
+// Append one range image. Returns 1 on success.
+int scan_recording_write(ScanRecording *recording, const float *range_image);
+
+// Open a recording for reading and load its header. Returns 1 on success.
+int scan_recording_open(ScanRecording *recording, const char *path);
+
+// Read the next frame into range_image (frame_floats floats). Returns 0 at
+// the end of the recording.
+int scan_recording_read(ScanRecording *recording, float *range_image);
+
+void scan_recording_close(ScanRecording *recording);
+
+#endif
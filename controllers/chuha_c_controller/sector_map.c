@@ -0,0 +1,144 @@
+/*
+ * ChuhaBot Polar Sector Map
+ * =========================
+ *
+ * Sector minimum summary with a sparse table for O(1) window queries.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "sector_map.h"
+#include "scan_kernels.h"
+
+#include <float.h>
+#include <math.h>
+
+#define TWO_PI (2.0 * 3.14159265359)
+
+static float min_float(float a, float b) {
+    return a < b ? a : b;
+}
+
+// floor(log2(length)) for every window length, so queries need no loop
+static unsigned char log2_floor[SECTOR_COUNT + 1];
+
+// Direction of every sector's center
+static float center_cos[SECTOR_COUNT], center_sin[SECTOR_COUNT];
+static int tables_ready = 0;
+
+static void build_tables(void) {
+    for (int length = 2; length <= SECTOR_COUNT; length++) {
+        log2_floor[length] = log2_floor[length / 2] + 1;
+    }
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        double center = -TWO_PI / 2.0 + (s + 0.5) * TWO_PI / SECTOR_COUNT;
+        center_cos[s] = (float)cos(center);
+        center_sin[s] = (float)sin(center);
+    }
+    tables_ready = 1;
+}
+
+void sector_map_bounds(int width, double first_angle, double beam_step, int bounds[SECTOR_COUNT + 1]) {
+    double sector_width = TWO_PI / SECTOR_COUNT;
+    for (int s = 0; s <= SECTOR_COUNT; s++) {
+        double edge = (-TWO_PI / 2.0 + s * sector_width - first_angle) / beam_step;
+        int beam = (int)ceil(edge - 1e-6);
+        bounds[s] = beam < 0 ? 0 : beam > width ? width : beam;
+    }
+}
+
+// Fill the upper sparse table levels from the per-sector minimums
+static void build_levels(SectorMap *map) {
+    if (!tables_ready) build_tables();
+
+    for (int k = 1; k < SECTOR_LEVELS; k++) {
+        int half = 1 << (k - 1);
+        for (int s = 0; s + (1 << k) <= SECTOR_COUNT; s++) {
+            map->min_range[k][s] = min_float(map->min_range[k - 1][s], map->min_range[k - 1][s + half]);
+        }
+    }
+}
+
+void sector_map_build(SectorMap *map, const float *hit_range, int width,
+                      double first_angle, double beam_step) {
+    int bounds[SECTOR_COUNT + 1];
+    sector_map_bounds(width, first_angle, beam_step, bounds);
+    map->sector_width = TWO_PI / SECTOR_COUNT;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        float closest = FLT_MAX;
+        for (int i = bounds[s]; i < bounds[s + 1]; i++) {
+            closest = min_float(closest, hit_range[i]);
+        }
+        map->min_range[0][s] = closest;
+    }
+    build_levels(map);
+}
+
+void sector_map_build_mm(SectorMap *map, const uint16_t *hit_range_mm, int width,
+                         double first_angle, double beam_step) {
+    int bounds[SECTOR_COUNT + 1];
+    sector_map_bounds(width, first_angle, beam_step, bounds);
+    map->sector_width = TWO_PI / SECTOR_COUNT;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        uint16_t closest = RANGE_MM_NONE;
+        for (int i = bounds[s]; i < bounds[s + 1]; i++) {
+            if (hit_range_mm[i] < closest) closest = hit_range_mm[i];
+        }
+        map->min_range[0][s] = closest == RANGE_MM_NONE ? FLT_MAX : closest / 1000.0f;
+    }
+    build_levels(map);
+}
+
+void sector_map_clear(SectorMap *map) {
+    map->sector_width = TWO_PI / SECTOR_COUNT;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        map->min_range[0][s] = FLT_MAX;
+    }
+    build_levels(map);
+}
+
+// Minimum over sectors first .. last (inclusive, first <= last): two overlapping lookups
+static float range_min(const SectorMap *map, int first, int last) {
+    int k = log2_floor[last - first + 1];
+    return min_float(map->min_range[k][first], map->min_range[k][last - (1 << k) + 1]);
+}
+
+float sector_map_query(const SectorMap *map, double from, double to) {
+    double span = fmod(to - from, TWO_PI);
+    if (span < 0.0) span += TWO_PI;
+
+    double start = fmod(from + TWO_PI / 2.0, TWO_PI);
+    if (start < 0.0) start += TWO_PI;
+
+    int first = (int)(start / map->sector_width);
+    int last = (int)((start + span) / map->sector_width);
+    if (first >= SECTOR_COUNT) first = SECTOR_COUNT - 1;
+    if (last - first >= SECTOR_COUNT - 1) {
+        return range_min(map, 0, SECTOR_COUNT - 1);
+    }
+
+    if (last < SECTOR_COUNT) {
+        return range_min(map, first, last);
+    }
+    return min_float(range_min(map, first, SECTOR_COUNT - 1),
+                     range_min(map, 0, last - SECTOR_COUNT));
+}
+
+float sector_map_sector_min(const SectorMap *map, int sector) {
+    return map->min_range[0][sector];
+}
+
+void sector_map_repulsion(const SectorMap *map, float min_range, float max_range, float offset,
+                          float *force_x, float *force_y) {
+    if (!tables_ready) build_tables();
+    float fx = 0.0f, fy = 0.0f;
+    for (int s = 0; s < SECTOR_COUNT; s++) {
+        float range = map->min_range[0][s];
+        float weight = range > min_range && range < max_range ? 1.0f / (range + offset) : 0.0f;
+        fx -= center_cos[s] * weight;
+        fy -= center_sin[s] * weight;
+    }
+    *force_x = fx;
+    *force_y = fy;
+}
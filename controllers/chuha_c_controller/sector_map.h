@@ -0,0 +1,63 @@
+/*
+ * ChuhaBot Polar Sector Map
+ * =========================
+ *
+ * Per-scan summary of the LIDAR hit profile: the closest hit in each of
+ * SECTOR_COUNT equal angular sectors, plus a sparse table over the sectors
+ * so "closest hit in angular window [from, to]" is answered in O(1)
+ * without rescanning the beams.
+ *
+ * Sectors cover the full circle from -PI, counter-clockwise, with 0
+ * straight ahead. Beams are placed by angle, so a LIDAR with a field of
+ * view below 2 * PI fills only the sectors it sees; the others stay clear.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef SECTOR_MAP_H
+#define SECTOR_MAP_H
+
+#include <stdint.h>
+
+#define SECTOR_COUNT 64
+#define SECTOR_LEVELS 7            // log2(SECTOR_COUNT) + 1
+
+typedef struct {
+    double sector_width;           // Radians per sector
+    // min_range[k][s] = closest hit in sectors s .. s + 2^k - 1 (FLT_MAX if none)
+    float min_range[SECTOR_LEVELS][SECTOR_COUNT];
+} SectorMap;
+
+// First beam of every sector for the beam layout below, bounds[s] ..
+// bounds[s + 1] - 1 being sector s. Beams sitting exactly on a sector edge
+// belong to the sector above it.
+void sector_map_bounds(int width, double first_angle, double beam_step, int bounds[SECTOR_COUNT + 1]);
+
+// Summarize a float hit profile (meters, FLT_MAX = no hit) of width evenly
+// spaced beams, beam i looking at first_angle + i * beam_step radians, with
+// every beam inside [-PI, PI)
+void sector_map_build(SectorMap *map, const float *hit_range, int width,
+                      double first_angle, double beam_step);
+
+// Same for a millimetre hit profile (RANGE_MM_NONE = no hit)
+void sector_map_build_mm(SectorMap *map, const uint16_t *hit_range_mm, int width,
+                         double first_angle, double beam_step);
+
+// Empty map, as for a scan without hits
+void sector_map_clear(SectorMap *map);
+
+// Closest hit in the counter-clockwise window from -> to (radians, may wrap
+// across +/-PI), at sector granularity. FLT_MAX if the window is clear.
+float sector_map_query(const SectorMap *map, double from, double to);
+
+// Closest hit in a single sector
+float sector_map_sector_min(const SectorMap *map, int sector);
+
+// Inverse-distance repulsion: every sector whose closest hit lies between
+// min_range and max_range pushes away from its center direction with weight
+// 1 / (range + offset). The sum is not normalized.
+void sector_map_repulsion(const SectorMap *map, float min_range, float max_range, float offset,
+                          float *force_x, float *force_y);
+
+#endif
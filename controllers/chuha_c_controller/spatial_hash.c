@@ -0,0 +1,197 @@
+/*
+ * ChuhaBot Spatial Hash
+ * =====================
+ *
+ * Cell binning, incremental re-sorting and span queries.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "spatial_hash.h"
+
+#include <math.h>
+#include <stdio.h>
+
+// Fall back to a full counting sort when more than 1 / FULL_SORT_FRACTION
+// of the robots changed cell; insertion sort is only cheap for a few movers
+#define FULL_SORT_FRACTION 8
+
+// Clamping before the conversion makes truncation equal floor and keeps
+// far-away positions from overflowing the int
+static inline int bin(float position, float inverse_cell, int bins) {
+    float f = position * inverse_cell;
+    f = f < 0.0f ? 0.0f : f;
+    f = f > (float)(bins - 1) ? (float)(bins - 1) : f;
+    return (int)f;
+}
+
+static int column_of(const SpatialHash *hash, float x) {
+    return bin(x - hash->origin_x, hash->inverse_cell, hash->columns);
+}
+
+static int row_of(const SpatialHash *hash, float y) {
+    return bin(y - hash->origin_y, hash->inverse_cell, hash->rows);
+}
+
+int spatial_hash_init(SpatialHash *hash, float min_x, float min_y,
+                      float max_x, float max_y, float radius) {
+    float width = max_x - min_x, height = max_y - min_y;
+    if (!(width > 0.0f && height > 0.0f && radius > 0.0f)) return -1;
+
+    float cell = radius;
+    long columns, rows;
+    for (;;) {
+        columns = (long)ceilf(width / cell);
+        rows = (long)ceilf(height / cell);
+        if (columns < 1) columns = 1;
+        if (rows < 1) rows = 1;
+        if (columns * rows <= SPATIAL_HASH_MAX_CELLS) break;
+        cell *= 1.1f;
+    }
+
+    hash->origin_x = min_x;
+    hash->origin_y = min_y;
+    hash->cell_size = cell;
+    hash->inverse_cell = 1.0f / cell;
+    hash->columns = (int)columns;
+    hash->rows = (int)rows;
+    hash->count = 0;
+    hash->moved = 0;
+    return 0;
+}
+
+// Stable counting sort of all robots by cell
+static void counting_sort(SpatialHash *hash, int count) {
+    int cells = hash->columns * hash->rows;
+    int *start = hash->cell_start;
+    for (int c = 0; c <= cells; c++) start[c] = 0;
+    for (int i = 0; i < count; i++) start[hash->cell[i] + 1]++;
+    for (int c = 0; c < cells; c++) start[c + 1] += start[c];
+    // Placing advances each start to the next cell's; cell_start is rebuilt afterwards
+    for (int i = 0; i < count; i++) hash->order[start[hash->cell[i]]++] = i;
+}
+
+// Re-sort last step's order; cost grows with how far robots moved in it
+static void insertion_sort(SpatialHash *hash, int count) {
+    for (int k = 1; k < count; k++) {
+        int robot = hash->order[k];
+        int key = hash->cell[robot];
+        int j = k - 1;
+        while (j >= 0 && hash->cell[hash->order[j]] > key) {
+            hash->order[j + 1] = hash->order[j];
+            j--;
+        }
+        hash->order[j + 1] = robot;
+    }
+}
+
+void spatial_hash_update(SpatialHash *hash, const float *x, const float *y, int count) {
+    if (count > SPATIAL_HASH_MAX_ROBOTS) count = SPATIAL_HASH_MAX_ROBOTS;
+    if (count < 0) count = 0;
+
+    int moved = 0;
+    for (int i = 0; i < count; i++) {
+        int cell = row_of(hash, y[i]) * hash->columns + column_of(hash, x[i]);
+        moved += cell != hash->cell[i];
+        hash->cell[i] = cell;
+    }
+
+    if (count != hash->count || moved * FULL_SORT_FRACTION > count) {
+        counting_sort(hash, count);
+        moved = count;
+    } else {
+        insertion_sort(hash, count);
+    }
+    hash->count = count;
+    hash->moved = moved;
+
+    for (int k = 0; k < count; k++) {
+        hash->x[k] = x[hash->order[k]];
+        hash->y[k] = y[hash->order[k]];
+    }
+
+    int cells = hash->columns * hash->rows;
+    int k = 0;
+    for (int c = 0; c <= cells; c++) {
+        while (k < count && hash->cell[hash->order[k]] < c) k++;
+        hash->cell_start[c] = k;
+    }
+}
+
+int spatial_hash_query(const SpatialHash *hash, float x, float y, SpatialSpan spans[3]) {
+    int column = column_of(hash, x), row = row_of(hash, y);
+    int first_column = column > 0 ? column - 1 : 0;
+    int last_column = column < hash->columns - 1 ? column + 1 : column;
+    int last_row = row < hash->rows - 1 ? row + 1 : row;
+    int n = 0;
+
+    for (int r = row > 0 ? row - 1 : 0; r <= last_row; r++) {
+        int begin = hash->cell_start[r * hash->columns + first_column];
+        int end = hash->cell_start[r * hash->columns + last_column + 1];
+        if (begin < end) {
+            spans[n].begin = begin;
+            spans[n].end = end;
+            n++;
+        }
+    }
+    return n;
+}
+
+// Deterministic positions for the self-check, no dependency on robot_rng
+static float check_random(unsigned int *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (*state >> 8) * (1.0f / 16777216.0f);
+}
+
+#define CHECK_ROBOTS 600
+#define CHECK_ARENA 10.0f
+#define CHECK_RADIUS 0.5f
+
+static SpatialHash check_hash;
+
+int spatial_hash_self_check(void) {
+    static float x[CHECK_ROBOTS], y[CHECK_ROBOTS];
+    unsigned int state = 12345u;
+    int mismatches = 0;
+
+    spatial_hash_init(&check_hash, 0.0f, 0.0f, CHECK_ARENA, CHECK_ARENA, CHECK_RADIUS);
+    for (int i = 0; i < CHECK_ROBOTS; i++) {
+        // A few robots start outside the arena to exercise the border clamp
+        x[i] = check_random(&state) * (CHECK_ARENA + 1.0f) - 0.5f;
+        y[i] = check_random(&state) * (CHECK_ARENA + 1.0f) - 0.5f;
+    }
+
+    // Small moves take the insertion sort path, the final jump the full sort
+    for (int step = 0; step < 6; step++) {
+        float jitter = step == 5 ? CHECK_ARENA : 0.05f;
+        for (int i = 0; i < CHECK_ROBOTS; i++) {
+            x[i] += (check_random(&state) - 0.5f) * jitter;
+            y[i] += (check_random(&state) - 0.5f) * jitter;
+        }
+        spatial_hash_update(&check_hash, x, y, CHECK_ROBOTS);
+
+        for (int i = 0; i < CHECK_ROBOTS; i++) {
+            int brute = 0, hashed = 0;
+            for (int j = 0; j < CHECK_ROBOTS; j++) {
+                float dx = x[j] - x[i], dy = y[j] - y[i];
+                brute += j != i && dx * dx + dy * dy <= CHECK_RADIUS * CHECK_RADIUS;
+            }
+
+            SpatialSpan spans[3];
+            int span_count = spatial_hash_query(&check_hash, x[i], y[i], spans);
+            for (int s = 0; s < span_count; s++) {
+                for (int k = spans[s].begin; k < spans[s].end; k++) {
+                    float dx = check_hash.x[k] - x[i], dy = check_hash.y[k] - y[i];
+                    hashed += check_hash.order[k] != i && dx * dx + dy * dy <= CHECK_RADIUS * CHECK_RADIUS;
+                }
+            }
+            if (brute != hashed) mismatches++;
+        }
+    }
+
+    if (mismatches > 0) {
+        printf("spatial_hash: %d neighbor counts differ from brute force\n", mismatches);
+    }
+    return mismatches;
+}
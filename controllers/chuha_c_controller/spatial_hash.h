@@ -0,0 +1,78 @@
+/*
+ * ChuhaBot Spatial Hash
+ * =====================
+ *
+ * Uniform grid over global robot positions for neighbor queries that scale
+ * linearly with the swarm, for supervisor-style code that knows where every
+ * robot is. The cell size is at least the interaction radius, so all
+ * neighbors of a robot lie in its own cell or the eight around it.
+ *
+ * Robots are kept sorted by cell, row-major, with positions copied into
+ * that order. The three cells of one grid row are consecutive, so a query
+ * returns at most three contiguous spans of the sorted arrays: the caller
+ * loops over hash->x[k], hash->y[k] for k in each span and filters by
+ * distance. hash->order[k] maps back to the caller's robot index.
+ *
+ * Updates are incremental: the sorted order from the previous step is
+ * reused and only robots that changed cell move in it (an insertion sort
+ * over a nearly sorted array). A full counting sort runs when the robot
+ * count changes or many robots changed cell at once.
+ *
+ * Positions outside the arena bounds are clamped to the border cells, which
+ * keeps queries correct but makes the border cells slower.
+ *
+ * The robot controller does not link this file, since a robot only sees its
+ * neighbors through the LIDAR. make bench builds it with
+ * host/spatial_hash_bench.c, which runs the self-check and times it.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#ifndef SPATIAL_HASH_MAX_ROBOTS
+#define SPATIAL_HASH_MAX_ROBOTS 2048
+#endif
+#ifndef SPATIAL_HASH_MAX_CELLS
+#define SPATIAL_HASH_MAX_CELLS 16384
+#endif
+
+// Sorted positions begin .. end - 1
+typedef struct {
+    int begin, end;
+} SpatialSpan;
+
+typedef struct {
+    float origin_x, origin_y;     // Arena minimum corner
+    float cell_size;              // Meters, >= the interaction radius
+    float inverse_cell;
+    int columns, rows;
+    int count;                    // Robots in the last update
+    int moved;                    // Robots that changed cell in the last update
+    int cell[SPATIAL_HASH_MAX_ROBOTS];     // Cell of each robot, by robot index
+    int order[SPATIAL_HASH_MAX_ROBOTS];    // Robot index at each sorted position
+    float x[SPATIAL_HASH_MAX_ROBOTS];      // Positions in sorted order
+    float y[SPATIAL_HASH_MAX_ROBOTS];
+    int cell_start[SPATIAL_HASH_MAX_CELLS + 1];  // First sorted position of each cell
+} SpatialHash;
+
+// Lay the grid over the arena. The cell size is radius, or larger if the
+// arena would need more than SPATIAL_HASH_MAX_CELLS cells. Returns 0, or -1
+// for an empty arena or non-positive radius.
+int spatial_hash_init(SpatialHash *hash, float min_x, float min_y,
+                      float max_x, float max_y, float radius);
+
+// Re-bin count robots (at most SPATIAL_HASH_MAX_ROBOTS) at their new positions
+void spatial_hash_update(SpatialHash *hash, const float *x, const float *y, int count);
+
+// Spans of the sorted arrays covering the 3 x 3 cells around (x, y). Returns
+// the number of non-empty spans written (0 to 3).
+int spatial_hash_query(const SpatialHash *hash, float x, float y, SpatialSpan spans[3]);
+
+// Compare neighbor sets against a brute-force search over several moving
+// steps. Returns the number of robots whose neighbor count differed.
+int spatial_hash_self_check(void);
+
+#endif
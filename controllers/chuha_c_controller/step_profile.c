@@ -0,0 +1,180 @@
+/*
+ * ChuhaBot Step Profile
+ * =====================
+ *
+ * Tick source, log-linear latency histograms and the profile report.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+// clock_gettime() is POSIX, not C99
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "step_profile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <x86intrin.h>
+#define TICKS_FROM_TSC
+#endif
+
+#define SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+#define MAX_VALUE ((1ULL << HISTOGRAM_MAX_BITS) - 1)
+
+static const char *const phase_names[PHASE_COUNT] = {
+    "keyboard", "calibration", "perception", "behaviors", "motors", "visualization", "step"
+};
+
+static uint64_t monotonic_nanoseconds(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    uint64_t ticks = (uint64_t)counter.QuadPart, hz = (uint64_t)frequency.QuadPart;
+    return ticks / hz * 1000000000ULL + ticks % hz * 1000000000ULL / hz;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+uint64_t step_profile_ticks(void) {
+#ifdef TICKS_FROM_TSC
+    return __rdtsc();
+#else
+    return monotonic_nanoseconds();
+#endif
+}
+
+// Index of the highest set bit, value > 0
+static inline int highest_bit(uint64_t value) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Values below 2 * SUB_COUNT map to themselves; above, the top
+// HISTOGRAM_SUB_BITS + 1 bits select the bucket within the power of two
+static inline int bucket_of(uint64_t value) {
+    if (value < 2 * SUB_COUNT) return (int)value;
+    int shift = highest_bit(value) - HISTOGRAM_SUB_BITS;
+    return (shift << HISTOGRAM_SUB_BITS) + (int)(value >> shift);
+}
+
+static void bucket_bounds(int bucket, uint64_t *low, uint64_t *high) {
+    if (bucket < 2 * SUB_COUNT) {
+        *low = *high = (uint64_t)bucket;
+        return;
+    }
+    int shift = (bucket >> HISTOGRAM_SUB_BITS) - 1;
+    *low = (uint64_t)((bucket & (SUB_COUNT - 1)) + SUB_COUNT) << shift;
+    *high = *low + (1ULL << shift) - 1;
+}
+
+void latency_histogram_record(LatencyHistogram *histogram, uint64_t ticks) {
+    if (ticks > MAX_VALUE) ticks = MAX_VALUE;
+    histogram->buckets[bucket_of(ticks)]++;
+    histogram->count++;
+    if (ticks > histogram->max) histogram->max = ticks;
+}
+
+uint64_t latency_histogram_percentile(const LatencyHistogram *histogram, double fraction) {
+    if (histogram->count == 0) return 0;
+    uint64_t target = (uint64_t)(fraction * histogram->count + 0.999999);
+    if (target < 1) target = 1;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+        seen += histogram->buckets[b];
+        if (seen >= target) {
+            uint64_t low, high;
+            bucket_bounds(b, &low, &high);
+            return high < histogram->max ? high : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+uint64_t step_profile_lap(StepProfile *profile, StepPhase phase, uint64_t mark) {
+    uint64_t now = step_profile_ticks();
+    latency_histogram_record(&profile->phase[phase], now - mark);
+    return now;
+}
+
+void step_profile_reset(StepProfile *profile) {
+    memset(profile, 0, sizeof(*profile));
+    profile->start_ticks = step_profile_ticks();
+    profile->start_nanoseconds = monotonic_nanoseconds();
+}
+
+void step_profile_report(const StepProfile *profile, const char *robot_name) {
+    // Microseconds per tick, measured over the run
+    double elapsed_ticks = (double)(step_profile_ticks() - profile->start_ticks);
+    double elapsed_nanoseconds = (double)(monotonic_nanoseconds() - profile->start_nanoseconds);
+    double us_per_tick = elapsed_ticks > 0.0 ? elapsed_nanoseconds / elapsed_ticks / 1000.0 : 0.001;
+
+    printf("[%s] Step profile (us)   count       p50       p99     p99.9       max\n", robot_name);
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        const LatencyHistogram *h = &profile->phase[p];
+        if (h->count == 0) continue;
+        printf("  %-16s %12llu %9.2f %9.2f %9.2f %9.2f\n", phase_names[p], (unsigned long long)h->count,
+               latency_histogram_percentile(h, 0.50) * us_per_tick,
+               latency_histogram_percentile(h, 0.99) * us_per_tick,
+               latency_histogram_percentile(h, 0.999) * us_per_tick,
+               h->max * us_per_tick);
+    }
+}
+
+static LatencyHistogram check_histogram;
+
+int step_profile_self_check(void) {
+    int failures = 0;
+
+    // Every value lies in its bucket, and buckets are at most 1/32 as wide as their start
+    for (uint64_t value = 0; value <= MAX_VALUE; value = value < 4096 ? value + 1 : value + value / 7 + 1) {
+        uint64_t low, high;
+        int bucket = bucket_of(value);
+        bucket_bounds(bucket, &low, &high);
+        if (bucket >= HISTOGRAM_BUCKETS || value < low || value > high || (high - low) * SUB_COUNT > low) {
+            if (failures++ == 0) {
+                printf("step_profile: %llu maps to bucket %d [%llu, %llu]\n", (unsigned long long)value,
+                       bucket, (unsigned long long)low, (unsigned long long)high);
+            }
+        }
+    }
+
+    // Uniform 1 .. 100000 ticks: percentiles within one bucket above the exact value
+    memset(&check_histogram, 0, sizeof(check_histogram));
+    for (uint64_t value = 1; value <= 100000; value++) latency_histogram_record(&check_histogram, value);
+    const double fractions[3] = {0.5, 0.99, 0.999};
+    for (int i = 0; i < 3; i++) {
+        uint64_t exact = (uint64_t)(fractions[i] * 100000);
+        uint64_t reported = latency_histogram_percentile(&check_histogram, fractions[i]);
+        if (reported < exact || reported > exact + exact / SUB_COUNT) {
+            printf("step_profile: p%g is %llu, expected about %llu\n", fractions[i] * 100,
+                   (unsigned long long)reported, (unsigned long long)exact);
+            failures++;
+        }
+    }
+    if (check_histogram.max != 100000 || latency_histogram_percentile(&check_histogram, 1.0) != 100000) {
+        printf("step_profile: max is not exact\n");
+        failures++;
+    }
+    return failures;
+}
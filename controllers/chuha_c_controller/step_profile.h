@@ -0,0 +1,82 @@
+/*
+ * ChuhaBot Step Profile
+ * =====================
+ *
+ * Per-phase latency of the control step. Each phase of run_step() is timed
+ * and the samples go into a fixed-size histogram in the style of
+ * HdrHistogram: values below 64 ticks get a bucket each, and every power of
+ * two above that is split into 32 linear sub-buckets, so a reported
+ * percentile is within ~3% of the true sample (at most 1/32 high). Memory
+ * does not grow with the number of samples and recording a sample is a few
+ * integer operations, with no allocation and no sorting.
+ *
+ * Ticks are the CPU time-stamp counter on x86 with GCC or Clang (about half
+ * the cost of clock_gettime) and monotonic-clock nanoseconds elsewhere. The
+ * report converts ticks to time with the ratio of both clocks over the
+ * run, so no calibration delay is needed at startup; this assumes an
+ * invariant TSC, as on any recent x86 CPU.
+ *
+ * Phases are timed as laps: step_profile_lap() charges the ticks since the
+ * previous mark to a phase and returns the new mark, so consecutive phases
+ * share one clock read.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef STEP_PROFILE_H
+#define STEP_PROFILE_H
+
+#include <stdint.h>
+
+#define HISTOGRAM_SUB_BITS 5                   // 32 sub-buckets per power of two
+#define HISTOGRAM_MAX_BITS 40                  // Samples are clamped below 2^40 ticks (minutes)
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+typedef enum {
+    PHASE_KEYBOARD,
+    PHASE_CALIBRATION,          // Only steps while --calibrate averages empty-arena scans
+    PHASE_PERCEPTION,           // Frame check, and the scan when a new one arrived
+    PHASE_BEHAVIORS,            // Forces and wheel speeds
+    PHASE_MOTORS,
+    PHASE_VISUALIZATION,        // Only steps that rendered a frame
+    PHASE_STEP,                 // run_step() from its start to the last phase
+    PHASE_COUNT
+} StepPhase;
+
+typedef struct {
+    uint64_t count;
+    uint64_t max;               // Ticks, exact
+    uint32_t buckets[HISTOGRAM_BUCKETS];
+} LatencyHistogram;
+
+typedef struct {
+    uint64_t start_ticks;       // Both clocks at the last reset, for the tick rate
+    uint64_t start_nanoseconds;
+    LatencyHistogram phase[PHASE_COUNT];
+} StepProfile;
+
+// Current time in ticks
+uint64_t step_profile_ticks(void);
+
+void latency_histogram_record(LatencyHistogram *histogram, uint64_t ticks);
+
+// Smallest bucket value that at least fraction (0 to 1) of the samples are
+// at or below, capped at the exact maximum. 0 for an empty histogram.
+uint64_t latency_histogram_percentile(const LatencyHistogram *histogram, double fraction);
+
+// Charge the ticks since mark to phase; returns the current ticks as the next mark
+uint64_t step_profile_lap(StepProfile *profile, StepPhase phase, uint64_t mark);
+
+// Empty all histograms and restart the tick rate measurement
+void step_profile_reset(StepProfile *profile);
+
+// Print count, p50, p99, p99.9 and max of every phase with samples, in
+// microseconds
+void step_profile_report(const StepProfile *profile, const char *robot_name);
+
+// Check bucket bounds and percentiles against known distributions. Returns
+// the number of failures.
+int step_profile_self_check(void);
+
+#endif
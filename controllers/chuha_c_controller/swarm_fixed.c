@@ -0,0 +1,126 @@
+/*
+ * ChuhaBot Fixed-Point Swarm Step
+ * ===============================
+ *
+ * Q16.16 port of calculate_swarm_forces() and
+ * forces_to_motor_velocities(). Keep the constants in step with
+ * chuha_c_controller.c.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "swarm_fixed.h"
+
+#define SEPARATION_RANGE Q16(0.8)
+#define SEPARATION_OFFSET Q16(0.1)
+#define COHESION_RANGE Q16(0.5)
+#define NORMALIZE_MIN_LENGTH Q16(0.001)
+#define WANDER_STEP Q16(0.2)
+#define TURN_HYSTERESIS Q16(0.5)
+#define TWO_PI (2 * Q16_PI)
+
+// Scale (x, y) to unit length unless it is (nearly) zero
+static void normalize(q16 *x, q16 *y) {
+    q16_unit_vector(*x, *y, NORMALIZE_MIN_LENGTH, x, y);
+}
+
+void swarm_fixed_init(FixedSwarm *swarm, q16 max_speed) {
+    swarm->weights.separation = Q16(2.0);
+    swarm->weights.alignment = Q16(1.0);
+    swarm->weights.cohesion = Q16(1.5);
+    swarm->weights.obstacle_avoidance = Q16(3.0);
+    swarm->weights.wander = Q16(0.5);
+    swarm->max_speed = max_speed;
+    swarm->wander_angle = 0;
+    swarm->turn_direction = 0;
+}
+
+// Add weight * (x, y) to the total
+static void accumulate(q16 *total_x, q16 *total_y, q16 weight, q16 x, q16 y) {
+    *total_x = q16_add(*total_x, q16_mul(weight, x));
+    *total_y = q16_add(*total_y, q16_mul(weight, y));
+}
+
+void swarm_fixed_step(FixedSwarm *swarm, const FixedInputs *inputs, FixedOutputs *outputs) {
+    const FixedWeights *weights = &swarm->weights;
+    q16 total_x = 0, total_y = 0;
+
+    // Neighbor sums in one pass, as accumulate_neighbor_sums() does
+    if (weights->separation || weights->alignment || weights->cohesion) {
+        // Separation terms are summed exactly, as Q16 positions times Q32
+        // weights (Q48). In a symmetric crowd they nearly cancel, and
+        // rounding each term to Q16 would dominate the direction of the sum.
+        int64_t sep_x = 0, sep_y = 0;
+        q16 vel_x = 0, vel_y = 0, pos_x = 0, pos_y = 0;
+        int tracked = 0;
+        for (int i = 0; i < inputs->count; i++) {
+            if (inputs->range[i] < SEPARATION_RANGE) {
+                int64_t weight = ((int64_t)1 << 48) / (inputs->range[i] + SEPARATION_OFFSET);
+                sep_x -= inputs->x[i] * weight;
+                sep_y -= inputs->y[i] * weight;
+            }
+            vel_x = q16_add(vel_x, inputs->vx[i]);
+            vel_y = q16_add(vel_y, inputs->vy[i]);
+            tracked += inputs->velocity_known[i];
+            pos_x = q16_add(pos_x, inputs->x[i]);
+            pos_y = q16_add(pos_y, inputs->y[i]);
+        }
+
+        if (weights->separation) {
+            q16 unit_x = q16_saturate(sep_x >> 32), unit_y = q16_saturate(sep_y >> 32);
+            q16_unit_vector(sep_x, sep_y, (int64_t)NORMALIZE_MIN_LENGTH << 32, &unit_x, &unit_y);
+            accumulate(&total_x, &total_y, weights->separation, unit_x, unit_y);
+        }
+        if (weights->alignment && tracked > 0) {
+            normalize(&vel_x, &vel_y);
+            accumulate(&total_x, &total_y, weights->alignment, vel_x, vel_y);
+        }
+        if (weights->cohesion && inputs->count > 0) {
+            q16 center_x = pos_x / inputs->count;
+            q16 center_y = pos_y / inputs->count;
+            if (q16_length(center_x, center_y) > COHESION_RANGE) {
+                normalize(&center_x, &center_y);
+                accumulate(&total_x, &total_y, weights->cohesion, center_x, center_y);
+            }
+        }
+    }
+
+    if (weights->obstacle_avoidance) {
+        accumulate(&total_x, &total_y, weights->obstacle_avoidance,
+                   inputs->obstacle_x, inputs->obstacle_y);
+    }
+
+    if (weights->wander) {
+        // Uniform step in [-0.1, 0.1) from the top 16 random bits
+        q16 uniform = (q16)(inputs->random_bits >> 16) - Q16_ONE / 2;
+        swarm->wander_angle += q16_mul(uniform, WANDER_STEP);
+        if (swarm->wander_angle > Q16_PI) swarm->wander_angle -= TWO_PI;
+        if (swarm->wander_angle < -Q16_PI) swarm->wander_angle += TWO_PI;
+        accumulate(&total_x, &total_y, weights->wander,
+                   q16_cos(swarm->wander_angle), q16_sin(swarm->wander_angle));
+    }
+
+    outputs->force_x = total_x;
+    outputs->force_y = total_y;
+
+    // Differential drive, saturating at every step. Inside the rear cone the
+    // robot keeps turning the way it turned last step, as
+    // forces_to_motor_velocities() does.
+    q16 desired_angle = q16_atan2(total_y, total_x);
+    if ((desired_angle > Q16_PI - TURN_HYSTERESIS && swarm->turn_direction < 0) ||
+        (desired_angle < TURN_HYSTERESIS - Q16_PI && swarm->turn_direction > 0)) {
+        desired_angle += swarm->turn_direction * TWO_PI;
+    }
+    q16 forward_speed = q16_mul(q16_length(total_x, total_y), swarm->max_speed / 2);
+    q16 turning_speed = q16_mul(desired_angle, q16_mul(swarm->max_speed, Q16(0.3)));
+    swarm->turn_direction = (turning_speed > 0) - (turning_speed < 0);
+    if (inputs->front_blocked) {
+        forward_speed = 0;
+    }
+
+    outputs->left_velocity = q16_clamp(q16_sub(forward_speed, turning_speed),
+                                       -swarm->max_speed, swarm->max_speed);
+    outputs->right_velocity = q16_clamp(q16_add(forward_speed, turning_speed),
+                                        -swarm->max_speed, swarm->max_speed);
+}
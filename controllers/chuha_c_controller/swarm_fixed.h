@@ -0,0 +1,58 @@
+/*
+ * ChuhaBot Fixed-Point Swarm Step
+ * ===============================
+ *
+ * The controller's steering pipeline in Q16.16: neighbor sums, the five
+ * behaviors, weighting, emergency braking and the differential drive
+ * conversion, using integer arithmetic only. It has no Webots or libm dependency, so the same
+ * file builds for the FPU-less ChuhaBot MCU.
+ *
+ * All lengths are meters, angles radians and speeds rad/s, in Q16.16.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef SWARM_FIXED_H
+#define SWARM_FIXED_H
+
+#include "fixed_point.h"
+
+typedef struct {
+    q16 separation;
+    q16 alignment;
+    q16 cohesion;
+    q16 obstacle_avoidance;
+    q16 wander;
+} FixedWeights;
+
+// One step's perception, as structure-of-arrays neighbor columns
+typedef struct {
+    int count;
+    const q16 *x, *y;
+    const q16 *range;
+    const q16 *vx, *vy;           // Zero unless the velocity is known
+    const int *velocity_known;
+    q16 obstacle_x, obstacle_y;   // Unit obstacle repulsion
+    int front_blocked;            // Something inside the braking window
+    uint32_t random_bits;         // Fresh random draw for wander
+} FixedInputs;
+
+typedef struct {
+    FixedWeights weights;
+    q16 max_speed;
+    q16 wander_angle;
+    int turn_direction;           // Sign of the last turn command: 1 left, -1 right, 0 none
+} FixedSwarm;
+
+typedef struct {
+    q16 force_x, force_y;         // Weighted behavior force
+    q16 left_velocity, right_velocity;
+} FixedOutputs;
+
+void swarm_fixed_init(FixedSwarm *swarm, q16 max_speed);
+
+// One control step. Behaviors whose weight is zero are skipped.
+void swarm_fixed_step(FixedSwarm *swarm, const FixedInputs *inputs, FixedOutputs *outputs);
+
+#endif
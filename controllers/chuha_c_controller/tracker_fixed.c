@@ -0,0 +1,147 @@
+/*
+ * ChuhaBot Fixed-Point Neighbor Tracker
+ * =====================================
+ *
+ * Q16.16 port of neighbor_tracker.c. Keep the filter in step with it.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#include "tracker_fixed.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_VELOCITY_VARIANCE Q32(1.0)
+
+static int compare_pairings(const void *a, const void *b) {
+    int64_t da = ((const FixedTrackPairing *)a)->distance_sq;
+    int64_t db = ((const FixedTrackPairing *)b)->distance_sq;
+    return (da > db) - (da < db);
+}
+
+void tracker_fixed_init(FixedTracker *tracker, q16 gate, int64_t process_noise,
+                        int64_t measurement_noise) {
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->next_id = 1;
+    tracker->gate = gate;
+    tracker->process_noise = process_noise;
+    tracker->measurement_noise = measurement_noise;
+}
+
+int tracker_fixed_is_confirmed(const FixedTrack *track) {
+    return track->active && track->hits >= TRACK_CONFIRM_HITS;
+}
+
+// Q32.32 value times dt
+static int64_t times_dt(int64_t value, q16 dt) {
+    return (value * dt) >> 16;
+}
+
+// Constant-velocity prediction of one axis with white acceleration noise.
+// dt^2 and dt^3 would lose most of their bits in Q16.16, so every term is
+// multiplied by dt one factor at a time.
+static void predict_axis(q16 *p, q16 *v, int64_t cov[3], q16 dt, int64_t q) {
+    int64_t q_dt = times_dt(q, dt);
+    int64_t q_dt2 = times_dt(q_dt, dt);
+    int64_t cov2_dt = times_dt(cov[2], dt);
+    *p = q16_add(*p, q16_mul(*v, dt));
+    cov[0] += 2 * times_dt(cov[1], dt) + times_dt(cov2_dt, dt) + times_dt(q_dt2, dt) / 3;
+    cov[1] += cov2_dt + q_dt2 / 2;
+    cov[2] += q_dt;
+}
+
+// Kalman update of one axis with a position measurement z; Q16.16 gains
+static void update_axis(q16 *p, q16 *v, int64_t cov[3], q16 z, int64_t r) {
+    int64_t s = cov[0] + r;
+    q16 k0 = q16_saturate(cov[0] * Q16_ONE / s);
+    q16 k1 = q16_saturate(cov[1] * Q16_ONE / s);
+    q16 innovation = q16_sub(z, *p);
+    *p = q16_add(*p, q16_mul(k0, innovation));
+    *v = q16_add(*v, q16_mul(k1, innovation));
+    cov[2] -= (k1 * cov[1]) >> 16;
+    cov[1] -= (k0 * cov[1]) >> 16;
+    cov[0] -= (k0 * cov[0]) >> 16;
+}
+
+static void start_track(FixedTracker *tracker, FixedTrack *track, q16 x, q16 y) {
+    track->active = 1;
+    track->id = tracker->next_id++;
+    track->hits = 1;
+    track->misses = 0;
+    track->state[0] = x;
+    track->state[1] = y;
+    track->state[2] = 0;
+    track->state[3] = 0;
+    for (int axis = 0; axis < 2; axis++) {
+        track->cov[axis][0] = tracker->measurement_noise;
+        track->cov[axis][1] = 0;
+        track->cov[axis][2] = INITIAL_VELOCITY_VARIANCE;
+    }
+}
+
+void tracker_fixed_update(FixedTracker *tracker, q16 dt, const q16 *det_x,
+                          const q16 *det_y, int count, int *track_index) {
+    FixedTrackPairing *pairings = tracker->pairings;
+    int track_taken[TRACKER_CAPACITY] = {0};
+    int pairing_count = 0;
+    int64_t gate_sq = (int64_t)tracker->gate * tracker->gate;
+
+    if (count > TRACKER_MAX_DETECTIONS) count = TRACKER_MAX_DETECTIONS;
+    for (int d = 0; d < count; d++) track_index[d] = -1;
+
+    // Predict every live track and collect gated pairings
+    for (int t = 0; t < TRACKER_CAPACITY; t++) {
+        FixedTrack *track = &tracker->tracks[t];
+        if (!track->active) continue;
+        predict_axis(&track->state[0], &track->state[2], track->cov[0], dt, tracker->process_noise);
+        predict_axis(&track->state[1], &track->state[3], track->cov[1], dt, tracker->process_noise);
+
+        for (int d = 0; d < count; d++) {
+            int64_t dx = (int64_t)det_x[d] - track->state[0];
+            int64_t dy = (int64_t)det_y[d] - track->state[1];
+            int64_t distance_sq = dx * dx + dy * dy;
+            if (distance_sq < gate_sq) {
+                pairings[pairing_count].distance_sq = distance_sq;
+                pairings[pairing_count].track = t;
+                pairings[pairing_count].detection = d;
+                pairing_count++;
+            }
+        }
+    }
+
+    // Greedy global nearest neighbor: closest pairs claim each other first
+    qsort(pairings, pairing_count, sizeof(FixedTrackPairing), compare_pairings);
+    for (int i = 0; i < pairing_count; i++) {
+        int t = pairings[i].track;
+        int d = pairings[i].detection;
+        if (track_taken[t] || track_index[d] >= 0) continue;
+
+        FixedTrack *track = &tracker->tracks[t];
+        update_axis(&track->state[0], &track->state[2], track->cov[0], det_x[d], tracker->measurement_noise);
+        update_axis(&track->state[1], &track->state[3], track->cov[1], det_y[d], tracker->measurement_noise);
+        track->hits++;
+        track->misses = 0;
+        track_taken[t] = 1;
+        track_index[d] = t;
+    }
+
+    // Coast unmatched tracks, dropping the ones lost for too long
+    for (int t = 0; t < TRACKER_CAPACITY; t++) {
+        FixedTrack *track = &tracker->tracks[t];
+        if (track->active && !track_taken[t] && ++track->misses > TRACK_MAX_MISSES) {
+            track->active = 0;
+        }
+    }
+
+    // Unmatched detections start new tracks in free slots
+    int free_slot = 0;
+    for (int d = 0; d < count; d++) {
+        if (track_index[d] >= 0) continue;
+        while (free_slot < TRACKER_CAPACITY && tracker->tracks[free_slot].active) free_slot++;
+        if (free_slot == TRACKER_CAPACITY) break;
+        start_track(tracker, &tracker->tracks[free_slot], det_x[d], det_y[d]);
+        track_index[d] = free_slot;
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * ChuhaBot Fixed-Point Neighbor Tracker
+ * =====================================
+ *
+ * Q16.16 port of neighbor_tracker.c for the fixed-point build: the same
+ * gated global-nearest-neighbor association and per-axis constant-velocity
+ * Kalman filters, with the same capacity and track lifecycle, using integer
+ * arithmetic only.
+ *
+ * Track states are Q16.16 meters and m/s. Variances of a few cm^2 would
+ * keep only a handful of bits in Q16.16, so covariances and the noise
+ * parameters are Q32.32 in int64_t.
+ *
+ * Author: Enhanced ChuhaBot Framework
+ * Date: June 2025
+ */
+
+#ifndef TRACKER_FIXED_H
+#define TRACKER_FIXED_H
+
+#include "fixed_point.h"
+#include "neighbor_tracker.h"     // TRACKER_CAPACITY, TRACK_CONFIRM_HITS, ...
+
+typedef struct {
+    int active;
+    int id;
+    int hits;
+    int misses;
+    q16 state[4];                 // x, y, vx, vy
+    int64_t cov[2][3];            // Per axis: var(p), cov(p, v), var(v), Q32.32
+} FixedTrack;
+
+typedef struct {
+    int64_t distance_sq;          // m^2, Q32.32
+    int track;
+    int detection;
+} FixedTrackPairing;
+
+typedef struct {
+    FixedTrack tracks[TRACKER_CAPACITY];
+    FixedTrackPairing pairings[TRACKER_CAPACITY * TRACKER_MAX_DETECTIONS];  // tracker_fixed_update() scratch
+    int next_id;
+    q16 gate;                     // Max association distance (m)
+    int64_t process_noise;        // Acceleration noise spectral density, Q32.32
+    int64_t measurement_noise;    // Position measurement variance (m^2), Q32.32
+} FixedTracker;
+
+void tracker_fixed_init(FixedTracker *tracker, q16 gate, int64_t process_noise,
+                        int64_t measurement_noise);
+
+// Advance all tracks by dt seconds and fold in this step's detections, as
+// tracker_update() does
+void tracker_fixed_update(FixedTracker *tracker, q16 dt, const q16 *det_x,
+                          const q16 *det_y, int count, int *track_index);
+
+int tracker_fixed_is_confirmed(const FixedTrack *track);
+
+#endif
@@ -57,6 +57,7 @@ except ImportError as e:
             self.display = display
         def clear(self): pass
         def drawPointCenter(self, x, y, size=5, color=0xFFFFFF): pass
+        def flush(self): pass
     
     def get_theta_data_aligned(lidar, sizes, ranges, epsilon):
         return []
@@ -447,6 +448,8 @@ class ChuhaEnhancedController:
             # Display mission mode and formation quality
             # (This would require text rendering capability in the display)
             
+            self.grapher.flush()
+            
         except Exception as e:
             print(f"Warning: Visualization failed: {e}")
     
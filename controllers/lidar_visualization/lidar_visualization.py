@@ -3,52 +3,10 @@
 from controller import Robot, Motor, PositionSensor, Keyboard, Lidar, Display
 import numpy as np
 
-#PLOTTING FUNCTIONS
-class Grapher:
-    def __init__(self, display):
-        '''
-        display: The display you wish to use with this.
-        '''
-        self.display = display 
-        self.width = display.getWidth()
-        self.height = display.getHeight()
-        self.defaultPointSize = int((self.height + self.width)/200)
-    def drawPointCorner(self, x, y, size=None, color=0x00FFFF):
-        '''
-        Draws square points wrt the top right corner. The size is in pixels.
-        '''
-        if(size is None):
-            size = self.defaultPointSize
-        self.display.setColor(color)
-        for row in range(max(0, y - size//2), min(self.height, y + size//2)):
-            for column in range(max(0, x - size//2), min(self.width, x + size//2)):
-                self.display.drawPixel(column, row)
-    def drawPointCenter(self, x, y, size=None, color=0x00FFFF):
-        '''
-        Draws square points taking the center (width//2, height//2) to be 0, 0.
-        '''
-        self.drawPointCorner(x + self.width//2, self.height//2-y, size, color)
-    def drawPointsListCenter(self, x_s, y_s, size = None, color=0x00FFFF):
-        '''
-        Draws points from two lists. If len_x != len_y, the trailing of x or y are truncated.        
-        '''
-        length = min(len(x_s), len(y_s))
-        for i in range(length):
-            self.drawPointCenter(x_s[i], y_s[i], size, color)
-
-    def clear(self, color=0x000000):
-        self.display.setColor(color)
-        self.display.fillRectangle(0, 0, self.width, self.height)
-
-    def lidar_plot(self, x_data, y_data, DISPLAY_SCALING_FACTOR):
-        x_s = []
-        y_s = []
-        for i in range(len(x_data)):
-            x_s.append(int(x_data[i]*DISPLAY_SCALING_FACTOR))
-            y_s.append(int(y_data[i]*DISPLAY_SCALING_FACTOR))
-        self.clear()
-        self.drawPointCenter(0, 0, color=0xFF0000)
-        self.drawPointsListCenter(x_s, y_s, size=5)
+#PLOTTING FUNCTIONS (shared batched Grapher)
+import sys, os
+sys.path.insert(0, os.path.abspath('..'))
+from swarm_basic_flocking.swarm_basic_flocking import Grapher
 
 def lidar_filter(imageArray, SIZES,RANGES,EPSILON):
     theta_data = np.zeros((SIZES[1],)).tolist()
@@ -136,4 +94,7 @@ while robot.step(timestep) != -1:
         for theta in range(len(theta_data)):
             x_data.append(-theta_data[theta]*np.cos(2*np.pi*theta/len(theta_data) + np.pi/2))
             y_data.append(theta_data[theta]*np.sin(2*np.pi*theta/len(theta_data) + np.pi/2))
-        grapher.lidar_plot(x_data, y_data, DISPLAY_SCALING_FACTOR)
+        grapher.clear()
+        grapher.drawPointCenter(0, 0, color=0xFF0000)
+        grapher.lidar_plot_without_clearing(x_data, y_data, DISPLAY_SCALING_FACTOR)
+        grapher.flush()
@@ -21,6 +21,12 @@ from controller import Robot, Motor, Lidar, Display, Keyboard
 import numpy as np
 #PLOTTING FUNCTIONS
 class Grapher:
+    '''
+    Points are drawn into a numpy image that mirrors the display, and flush() sends
+    the region that changed since the last flush as one image (imageNew/imagePaste).
+    Nothing reaches the display until flush() is called, so call it once per frame.
+    If the display cannot take images, each point becomes one fillRectangle call.
+    '''
     def __init__(self, display):
         '''
         display: The display you wish to use with this.
@@ -29,16 +35,41 @@ class Grapher:
         self.width = display.getWidth()
         self.height = display.getHeight()
         self.defaultPointSize = int((self.height + self.width)/200)
+        self.useImage = hasattr(display, 'imageNew')
+        self.image = np.zeros((self.height, self.width, 4), dtype=np.uint8) #BGRA, as the display stores it
+        self.image[:, :, 3] = 0xFF
+        self.background = 0x000000
+        self.pending = [] #(color, x, y, width, height) since the last flush, for the fallback
+        self.dirty = (0, 0, self.width, self.height) #(x0, y0, x1, y1) changed since the last flush; all of it at first
+        self.drawn = None #(x0, y0, x1, y1) drawn on since the last clear
+    @staticmethod
+    def bgra(color):
+        return ((color & 0xFF), (color >> 8) & 0xFF, (color >> 16) & 0xFF, 0xFF)
+    @staticmethod
+    def union(box, x0, y0, x1, y1):
+        if(box is None):
+            return (x0, y0, x1, y1)
+        return (min(box[0], x0), min(box[1], y0), max(box[2], x1), max(box[3], y1))
+    def fillRectangle(self, x, y, width, height, color):
+        '''
+        Fills a clipped rectangle of the frame.
+        '''
+        x0, y0 = max(0, x), max(0, y)
+        x1, y1 = min(self.width, x + width), min(self.height, y + height)
+        if(x0 >= x1 or y0 >= y1):
+            return
+        self.pending.append((color, x0, y0, x1 - x0, y1 - y0))
+        if(self.useImage):
+            self.image[y0:y1, x0:x1] = self.bgra(color)
+            self.dirty = self.union(self.dirty, x0, y0, x1, y1)
+            self.drawn = self.union(self.drawn, x0, y0, x1, y1)
     def drawPointCorner(self, x, y, size=None, color=0x00FFFF):
         '''
         Draws square points wrt the top right corner. The size is in pixels.
         '''
         if(size is None):
             size = self.defaultPointSize
-        self.display.setColor(color)
-        for row in range(max(0, y - size//2), min(self.height, y + size//2)):
-            for column in range(max(0, x - size//2), min(self.width, x + size//2)):
-                self.display.drawPixel(column, row)
+        self.fillRectangle(x - size//2, y - size//2, size//2 * 2, size//2 * 2, color)
     def drawPointCenter(self, x, y, size=None, color=0x00FFFF):
         '''
         Draws square points taking the center (width//2, height//2) to be 0, 0.
@@ -50,21 +81,50 @@ class Grapher:
         '''
         length = min(len(x_s), len(y_s))
         for i in range(length):
-            self.drawPointCenter(x_s[i], y_s[i], size, color)
+            self.drawPointCenter(int(x_s[i]), int(y_s[i]), size, color)
 
     def clear(self, color=0x000000):
-        self.display.setColor(color)
-        self.display.fillRectangle(0, 0, self.width, self.height)
+        self.pending = [(color, 0, 0, self.width, self.height)]
+        if(self.useImage):
+            self.image[:, :] = self.bgra(color)
+            #Only what was drawn since the last clear differs, unless the background changed
+            if(color != self.background):
+                self.dirty = (0, 0, self.width, self.height)
+            elif(self.drawn is not None):
+                self.dirty = self.union(self.dirty, *self.drawn)
+            self.background = color
+            self.drawn = None
+    def flush(self):
+        '''
+        Sends everything drawn since the last flush to the display.
+        '''
+        if(self.useImage and self.dirty is not None):
+            x0, y0, x1, y1 = self.dirty
+            try:
+                region = np.ascontiguousarray(self.image[y0:y1, x0:x1])
+                ir = self.display.imageNew(region.tobytes(), Display.BGRA, x1 - x0, y1 - y0)
+                self.display.imagePaste(ir, x0, y0)
+                self.display.imageDelete(ir)
+            except (TypeError, AttributeError):
+                #This Webots version cannot take byte images: draw rectangles from now on
+                self.useImage = False
+        if(not self.useImage):
+            color = None
+            for rectangle in self.pending:
+                if(rectangle[0] != color):
+                    color = rectangle[0]
+                    self.display.setColor(color)
+                self.display.fillRectangle(*rectangle[1:])
+        self.pending = []
+        self.dirty = None
 
     def lidar_plot(self, x_data, y_data, DISPLAY_SCALING_FACTOR, color=0x00FFFF, size=5):
         self.clear()
-        self.lidar_plot_without_clearing(x_data, y_data, DISPLAY_SCALING_FACTOR, color, size=5)
+        self.lidar_plot_without_clearing(x_data, y_data, DISPLAY_SCALING_FACTOR, color, size)
+        self.flush()
     def lidar_plot_without_clearing(self, x_data, y_data, DISPLAY_SCALING_FACTOR, color=0x00FFFF, size=5):
-        x_s = []
-        y_s = []
-        for i in range(len(x_data)):
-            x_s.append(int(x_data[i]*DISPLAY_SCALING_FACTOR))
-            y_s.append(int(y_data[i]*DISPLAY_SCALING_FACTOR))
+        x_s = (np.asarray(x_data, dtype=float)*DISPLAY_SCALING_FACTOR).astype(int)
+        y_s = (np.asarray(y_data, dtype=float)*DISPLAY_SCALING_FACTOR).astype(int)
         # self.drawPointCenter(0, 0, color=0xFF0000)
         self.drawPointsListCenter(x_s, y_s, size=size,color=color)
 def lidar_filter(imageArray, SIZES,RANGES,EPSILON):
@@ -147,6 +207,7 @@ def get_neighbours(theta_data_colored,DISPLAY_SCALING_FACTOR=None,colors=None, g
                 color_index = (color_index + 1)%len(colors)
     if(shouldGraph):
         grapher.lidar_plot_without_clearing(neighbours_positions_x, neighbours_positions_y,DISPLAY_SCALING_FACTOR, size=10, color=0x808080)    
+        grapher.flush()
     return neighbours_positions_x, neighbours_positions_y
 def swarm_control(neighbours_positions_x, neighbours_positions_y, left_motor, right_motor, VELOCITY):
     '''